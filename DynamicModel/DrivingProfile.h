@@ -0,0 +1,57 @@
+//
+// Created by fyh on 25-8-15.
+//
+
+#ifndef DRIVINGPROFILE_H
+#define DRIVINGPROFILE_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 驾驶工况
+enum class DrivingRegime : uint8_t {
+    TRACTION, // 最大牵引
+    CRUISE,   // 恒速（牵引抵消阻力）
+    COAST,    // 惰行（无牵引、无制动）
+    BRAKE     // 最大制动
+};
+
+// 剖面上某一里程处的目标速度与工况
+struct DrivingProfilePoint {
+    double distance = 0.0; // 走行距离 (m)
+    double speed = 0.0;    // 到达该点时的速度 (m/s)
+    DrivingRegime regime = DrivingRegime::COAST; // 从该点到下一点的工况
+};
+
+/**
+ * @brief 沿走行距离等间隔的驾驶剖面，供自动模式跟随。
+ */
+class DrivingProfile {
+public:
+    DrivingProfile() = default;
+    DrivingProfile(std::vector<DrivingProfilePoint> points, double step)
+        : points_(std::move(points)), step_(step), inv_step_(step > 0.0 ? 1.0 / step : 0.0) {}
+
+    // 距离 s 所在区间的起点下标
+    size_t indexAt(double distance) const {
+        if (points_.empty() || distance <= 0.0) return 0;
+        const auto idx = static_cast<size_t>(distance * inv_step_);
+        return idx < points_.size() ? idx : points_.size() - 1;
+    }
+
+    const DrivingProfilePoint& point(size_t index) const { return points_[index]; }
+    const std::vector<DrivingProfilePoint>& points() const { return points_; }
+    size_t size() const { return points_.size(); }
+    bool empty() const { return points_.empty(); }
+    double step() const { return step_; }
+
+private:
+    std::vector<DrivingProfilePoint> points_;
+    double step_ = 0.0;
+    double inv_step_ = 0.0;
+};
+
+#endif //DRIVINGPROFILE_H
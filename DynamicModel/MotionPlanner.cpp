@@ -3,7 +3,9 @@
 #include <cmath>
 
 MotionPlanner::MotionPlanner(const MotionConstraints& constraints)
-    : constraints_(constraints) {}
+    : constraints_(constraints) {
+    setJerkGear(jerk_gear_);
+}
 
 void MotionPlanner::setTargetVelocity(double target_vel) {
     target_velocity_ = std::clamp(target_vel, 0.0, constraints_.max_velocity);
@@ -13,66 +15,93 @@ void MotionPlanner::setTargetAcceleration(double target_accel) {
     target_acceleration_ = std::clamp(target_accel, constraints_.min_acceleration, constraints_.max_acceleration);
 }
 
+void MotionPlanner::setResistanceAcceleration(double resistance_accel) {
+    resistance_acceleration_ = resistance_accel;
+}
+
+void MotionPlanner::setJerkGear(int gear) {
+    jerk_gear_ = std::clamp(gear, 0, 2);
+    jerk_ = constraints_.max_jerk[jerk_gear_];
+    half_inv_jerk_ = 0.5 / jerk_;
+}
+
+MotionPlanner::Kernel MotionPlanner::selectKernel(ControlPolicy policy) {
+    return policy == ControlPolicy::VELOCITY_TARGET ? &kernel<ControlPolicy::VELOCITY_TARGET>
+                                                    : &kernel<ControlPolicy::ACCELERATION_TARGET>;
+}
+
 void MotionPlanner::update_for_velocity(double dt, KinematicState& current_state) {
-    // 1. 计算速度误差
-    double velocity_error = target_velocity_ - current_state.velocity;
+    kernel<ControlPolicy::VELOCITY_TARGET>(*this, dt, current_state);
+}
 
-    // 2. 估算减速到0所需的速度变化
-    double time_to_stop_accel = current_state.acceleration / constraints_.max_jerk[2];
-    double vel_change_to_stop_accel = 0.5 * current_state.acceleration * time_to_stop_accel;
+void MotionPlanner::update_for_acceleration(double dt, KinematicState& current_state) {
+    kernel<ControlPolicy::ACCELERATION_TARGET>(*this, dt, current_state);
+}
 
-    // 3. 决定理想加速度
-    double target_accel = 0.0;
-    if (std::abs(velocity_error) > std::abs(vel_change_to_stop_accel)) {
-        target_accel = (velocity_error > 0) ? constraints_.max_acceleration : constraints_.min_acceleration;
-    } else {
-        target_accel = 0.0;
-    }
+template<ControlPolicy Policy>
+void MotionPlanner::kernel(MotionPlanner& planner, double dt, KinematicState& current_state) {
+    const MotionConstraints& constraints = planner.constraints_;
 
-    // 4. 计算加速度误差，并根据Jerk平滑过渡
-    double accel_error = target_accel - current_state.acceleration;
-    if (std::abs(accel_error) < constraints_.max_jerk[2] * dt) {
-        current_state.acceleration = target_accel;
-        current_state.jerk = 0;
-    } else {
-        double sign_a_err = (accel_error > 0) ? 1.0 : -1.0;
-        current_state.jerk = sign_a_err * constraints_.max_jerk[2];
-    }
+    if constexpr (Policy == ControlPolicy::VELOCITY_TARGET) {
+        // 1. 计算速度误差
+        const double velocity_error = planner.target_velocity_ - current_state.velocity;
 
-    // 5. 积分更新状态
-    current_state.position += current_state.velocity * dt + 0.5 * current_state.acceleration * dt * dt + (1.0/6.0) * current_state.jerk * dt * dt * dt;
-    current_state.velocity += current_state.acceleration * dt + 0.5 * current_state.jerk * dt * dt;
-    current_state.acceleration += current_state.jerk * dt;
+        // 2. 估算减速到0所需的速度变化: 0.5 * a^2 / jerk
+        const double vel_change_to_stop_accel =
+            current_state.acceleration * current_state.acceleration * planner.half_inv_jerk_;
 
-    // 6. 施加约束
-    current_state.acceleration = std::clamp(current_state.acceleration, constraints_.min_acceleration, constraints_.max_acceleration);
-    current_state.velocity = std::clamp(current_state.velocity, 0.0, constraints_.max_velocity);
+        // 3. 决定理想加速度
+        double target_accel = 0.0;
+        if (std::abs(velocity_error) > vel_change_to_stop_accel) {
+            target_accel = (velocity_error > 0) ? constraints.max_acceleration : constraints.min_acceleration;
+        }
+
+        // 4. 前馈补偿阻力：恒速时牵引力恰好抵消阻力
+        const double target_applied = std::clamp(target_accel + planner.resistance_acceleration_,
+                                                 constraints.min_acceleration, constraints.max_acceleration);
+
+        // 5. 根据Jerk平滑过渡并积分
+        planner.step_applied_acceleration(target_applied, dt, current_state);
+    } else {
+        planner.step_applied_acceleration(planner.target_acceleration_, dt, current_state);
+
+        if (current_state.velocity >= constraints.max_velocity && current_state.acceleration > 0) {
+            current_state.acceleration = 0;
+            current_state.jerk = 0; // 同时也将Jerk清零
+        }
+    }
 }
 
-void MotionPlanner::update_for_acceleration(double dt, KinematicState& current_state) {
-    // 1. 计算加速度误差
-    double accel_error = target_acceleration_ - current_state.acceleration;
+void MotionPlanner::step_applied_acceleration(double target_applied, double dt, KinematicState& current_state) {
+    // 步长相关常量每次现算：几次乘法比从对象中读取缓存更省（车队场景下受内存带宽限制）
+    const double half_dt2 = 0.5 * dt * dt;
+    const double sixth_dt3 = half_dt2 * dt * (1.0 / 3.0);
 
-    // 2. 根据Jerk限制决定当前的jerk值
-    if (std::abs(accel_error) < constraints_.max_jerk[2] * dt) {
-        current_state.acceleration = target_acceleration_;
+    // 1. 计算加速度误差，并根据Jerk限制决定当前的jerk值
+    const double accel_error = target_applied - applied_acceleration_;
+    if (std::abs(accel_error) < jerk_ * dt) {
+        applied_acceleration_ = target_applied;
         current_state.jerk = 0;
     } else {
-        double sign_a_err = (accel_error > 0) ? 1.0 : -1.0;
-        current_state.jerk = sign_a_err * constraints_.max_jerk[2];
+        current_state.jerk = (accel_error > 0) ? jerk_ : -jerk_;
     }
 
+    // 2. 列车实际加速度 = 牵引/制动加速度 - 阻力减速度
+    current_state.acceleration = applied_acceleration_ - resistance_acceleration_;
+
     // 3. 积分更新状态
-    current_state.position += current_state.velocity * dt + 0.5 * current_state.acceleration * dt * dt + (1.0/6.0) * current_state.jerk * dt * dt * dt;
-    current_state.velocity += current_state.acceleration * dt + 0.5 * current_state.jerk * dt * dt;
-    current_state.acceleration += current_state.jerk * dt;
+    current_state.position += current_state.velocity * dt + current_state.acceleration * half_dt2 + current_state.jerk * sixth_dt3;
+    current_state.velocity += current_state.acceleration * dt + current_state.jerk * half_dt2;
+    applied_acceleration_ += current_state.jerk * dt;
 
     // 4. 施加约束
-    current_state.acceleration = std::clamp(current_state.acceleration, constraints_.min_acceleration, constraints_.max_acceleration);
+    applied_acceleration_ = std::clamp(applied_acceleration_, constraints_.min_acceleration, constraints_.max_acceleration);
+    current_state.acceleration = applied_acceleration_ - resistance_acceleration_;
     current_state.velocity = std::clamp(current_state.velocity, 0.0, constraints_.max_velocity);
 
-    if (current_state.velocity >= constraints_.max_velocity && current_state.acceleration > 0) {
-        current_state.acceleration = 0;
-        current_state.jerk = 0; // 同时也将Jerk清零
+    // 静止时阻力不会使列车后退
+    if (current_state.velocity <= 0.0 && current_state.acceleration < 0.0) {
+        current_state.acceleration = 0.0;
+        current_state.jerk = 0.0;
     }
-}
\ No newline at end of file
+}
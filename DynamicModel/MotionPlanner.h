@@ -2,13 +2,30 @@
 #include "KinematicState.h"
 #include "MotionConstraints.h"
 
+// 规划器的控制策略
+enum class ControlPolicy {
+    VELOCITY_TARGET,     // 跟踪目标速度（自动模式）
+    ACCELERATION_TARGET  // 跟踪目标加速度（手动模式）
+};
+
 class MotionPlanner {
 public:
+    // 按策略特化的更新内核，由调用方预先选定后每周期直接调用；当前Jerk档位的常量保存在规划器中
+    using Kernel = void (*)(MotionPlanner& planner, double dt, KinematicState& current_state);
+
     MotionPlanner(const MotionConstraints& constraints);
 
     // --- 接口 ---
     void setTargetVelocity(double target_vel);     // 给自动模式使用
-    void setTargetAcceleration(double target_accel); // 给手动模式使用
+    void setTargetAcceleration(double target_accel); // 给手动模式使用（牵引/制动力对应的加速度）
+    // 当前位置与速度下的运行阻力减速度 (m/s^2)，正值阻碍前进
+    void setResistanceAcceleration(double resistance_accel);
+    // 选择Jerk档位 (0/1/2 对应 MotionConstraints::max_jerk)，同时刷新该档位的折叠常量
+    void setJerkGear(int gear);
+    int getJerkGear() const { return jerk_gear_; }
+
+    // 取得与策略对应的特化内核
+    static Kernel selectKernel(ControlPolicy policy);
 
     // --- 更新函数 ---
     // 根据目标速度进行更新 (原始逻辑)
@@ -17,7 +34,21 @@ public:
     void update_for_acceleration(double dt, KinematicState& current_state);
 
 private:
-    MotionConstraints constraints_;
+    template<ControlPolicy Policy>
+    static void kernel(MotionPlanner& planner, double dt, KinematicState& current_state);
+
+    // 牵引/制动加速度按Jerk限制逼近目标，扣除阻力后积分得到列车状态。
+    // 声明为 inline：库以共享库构建，非 inline 成员在内核中会经 PLT 调用而无法内联
+    inline void step_applied_acceleration(double target_applied, double dt, KinematicState& current_state);
+
+    // 车队场景下规划器数量很大，每周期访问的字段集中在对象开头，且只保存当前档位的常量
     double target_velocity_ = 0.0;
     double target_acceleration_ = 0.0;
-};
\ No newline at end of file
+    double resistance_acceleration_ = 0.0;
+    double applied_acceleration_ = 0.0; // 牵引/制动力产生的加速度（不含阻力）
+    double jerk_ = 0.0;                 // max_jerk[jerk_gear_]
+    double half_inv_jerk_ = 0.0;        // 0.5 / jerk_
+
+    MotionConstraints constraints_;
+    int jerk_gear_ = 2;
+};
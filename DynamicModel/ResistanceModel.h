@@ -0,0 +1,44 @@
+//
+// Created by fyh on 25-8-12.
+//
+
+#ifndef RESISTANCEMODEL_H
+#define RESISTANCEMODEL_H
+#pragma once
+
+#include "TrajKit/TrackProfile.h"
+
+// 列车运行阻力计算 (单位阻力 N/kN 换算为减速度 m/s^2)
+namespace ResistanceModel {
+    constexpr double GRAVITY = 9.81;                 // 重力加速度 (m/s^2)
+    constexpr double CURVE_RESISTANCE_FACTOR = 600.0; // 曲线附加阻力 w_r = 600 / R (N/kN)
+
+    // 基本阻力 (Davis): w0 = a + b*v + c*v^2，v 单位 km/h，结果单位 N/kN
+    inline double basicResistance(const double coefficients[3], double speed_mps) {
+        const double v_kmh = speed_mps * 3.6;
+        return coefficients[0] + (coefficients[1] + coefficients[2] * v_kmh) * v_kmh;
+    }
+
+    // 坡道附加阻力 w_i = 1000 * sinθ (N/kN)，上坡为正
+    inline double gradeResistance(const TrackProfilePoint& profile) {
+        return 1000.0 * profile.grade;
+    }
+
+    // 曲线附加阻力 w_r = 600 * κ (N/kN)
+    inline double curveResistance(const TrackProfilePoint& profile) {
+        return CURVE_RESISTANCE_FACTOR * profile.curvature;
+    }
+
+    // 单位阻力 (N/kN) -> 阻力减速度 (m/s^2)
+    inline double toAcceleration(double specific_resistance) {
+        return specific_resistance * GRAVITY / 1000.0;
+    }
+
+    // 合成阻力减速度，正值表示阻碍列车前进
+    inline double totalAcceleration(const double coefficients[3], double speed_mps, const TrackProfilePoint& profile) {
+        const double basic = speed_mps > 0.0 ? basicResistance(coefficients, speed_mps) : 0.0;
+        return toAcceleration(basic + gradeResistance(profile) + curveResistance(profile));
+    }
+}
+
+#endif //RESISTANCEMODEL_H
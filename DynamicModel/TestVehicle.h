@@ -11,7 +11,7 @@ struct TrainInfo {
     std::wstring trainType;                 // 列车类型
     double maxSpeed;                    // 最大速度(km/h)
     double trainLong;                     // 列车长度(m)
-    double resistanceCoefficients[3];         // 基本阻力公式
+    double resistanceCoefficients[3];         // 基本阻力公式 a + b*v + c*v^2 (N/kN, v 单位 km/h)
     double tractionAcceleration;        // 最大加速度(m/s²)
     double brakingAcceleration;         // 最大减速度(m/s²)
 };
@@ -1,16 +1,38 @@
 #include "TrainController.h"
+#include "ResistanceModel.h"
 #include <chrono>
 #include <thread>
 #include <stdexcept>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 
-TrainController::TrainController(const TrainInfo& train_info, double track_length)
+TrainController::TrainController(const TrainInfo& train_info, double track_length, const TrackProfile* track_profile,
+                                 bool enable_logging)
     : constraints_(create_constraints_from_info(train_info)),
       planner_(constraints_),
-      track_length_(track_length)
+      track_length_(track_length),
+      resistance_coefficients_{train_info.resistanceCoefficients[0], train_info.resistanceCoefficients[1], train_info.resistanceCoefficients[2]},
+      track_profile_(track_profile),
+      logging_enabled_(enable_logging)
 {
     station_position_ = track_length_;
+
+    const double max_a = constraints_.max_acceleration;
+    const double min_a = constraints_.min_acceleration;
+    level_targets_[static_cast<int>(ControlLevel::IDLE)]       = {0.0, 0.0};
+    level_targets_[static_cast<int>(ControlLevel::CRUISE)]     = {0.0, 1.0}; // 牵引抵消阻力以保持速度
+    level_targets_[static_cast<int>(ControlLevel::TRACTION_1)] = {max_a * (1.0 / 3.0), 0.0};
+    level_targets_[static_cast<int>(ControlLevel::TRACTION_2)] = {max_a * (2.0 / 3.0), 0.0};
+    level_targets_[static_cast<int>(ControlLevel::TRACTION_3)] = {max_a, 0.0};
+    level_targets_[static_cast<int>(ControlLevel::BRAKE_1)]    = {min_a * (1.0 / 3.0), 0.0};
+    level_targets_[static_cast<int>(ControlLevel::BRAKE_2)]    = {min_a * (2.0 / 3.0), 0.0};
+    level_targets_[static_cast<int>(ControlLevel::BRAKE_3)]    = {min_a, 0.0};
+    select_kernels();
+
+    if (!logging_enabled_) {
+        return;
+    }
     std::cout << "1D Simulation configured. Track length: " << track_length_ << "m, Target station: " << station_position_ << "m." << std::endl;
     std::cout << "Train Constraints: MaxVel=" << constraints_.max_velocity << " m/s, MaxAccel=" << constraints_.max_acceleration << " m/s^2, MinAccel=" << constraints_.min_acceleration << " m/s^2" << std::endl;
     std::cout << "Jerk Gears (Low/Mid/High): " << constraints_.max_jerk[0] << "/" << constraints_.max_jerk[1] << "/" << constraints_.max_jerk[2] << " m/s^3" << std::endl;
@@ -22,6 +44,27 @@ TrainController::TrainController(const TrainInfo& train_info, double track_lengt
     }
 }
 
+TrainController::TrainController(const TrainController& other)
+    : m_control_mode(other.m_control_mode),
+      m_current_level(other.m_current_level),
+      train_state_(other.train_state_),
+      state_(other.state_),
+      constraints_(other.constraints_),
+      planner_(other.planner_),
+      mode_update_(other.mode_update_),
+      planner_kernel_(other.planner_kernel_),
+      coast_kernel_(other.coast_kernel_),
+      driving_profile_(other.driving_profile_),
+      track_length_(other.track_length_),
+      station_position_(other.station_position_),
+      resistance_coefficients_{other.resistance_coefficients_[0], other.resistance_coefficients_[1], other.resistance_coefficients_[2]},
+      track_profile_(other.track_profile_),
+      stop_position_(other.stop_position_),
+      logging_enabled_(false)
+{
+    std::copy(std::begin(other.level_targets_), std::end(other.level_targets_), std::begin(level_targets_));
+}
+
 TrainController::~TrainController() {
     if (output_file_.is_open()) {
         output_file_.close();
@@ -31,12 +74,13 @@ TrainController::~TrainController() {
 
 void TrainController::setControlMode(ControlMode mode) {
     m_control_mode = mode;
+    select_kernels();
     if (mode == ControlMode::AUTOMATIC) {
-        std::cout << "Switched to AUTOMATIC mode." << std::endl;
+        if (logging_enabled_) std::cout << "Switched to AUTOMATIC mode." << std::endl;
         train_state_ = TrainState::STOPPED; // 重置自动模式状态
         planner_.setTargetVelocity(0.0); // 确保目标速度为0
     } else {
-        std::cout << "Switched to MANUAL mode." << std::endl;
+        if (logging_enabled_) std::cout << "Switched to MANUAL mode." << std::endl;
     }
 }
 
@@ -49,43 +93,39 @@ void TrainController::setControlLevel(ControlLevel level) {
     }
 }
 
-void TrainController::update(double dt) {
-    switch (m_control_mode) {
-        case ControlMode::AUTOMATIC:
-            update_state_machine();
-            planner_.update_for_velocity(dt, state_);
-            break;
-
-        case ControlMode::MANUAL:
-        { // 使用花括号创建一个作用域
-            double target_accel = 0.0;
-            switch (m_current_level) {
-                case ControlLevel::IDLE:       target_accel = 0.0; break;
-                case ControlLevel::CRUISE:     target_accel = 0.0; break;
-                case ControlLevel::TRACTION_1: target_accel = constraints_.max_acceleration * (1.0 / 3.0); break;
-                case ControlLevel::TRACTION_2: target_accel = constraints_.max_acceleration * (2.0 / 3.0); break;
-                case ControlLevel::TRACTION_3: target_accel = constraints_.max_acceleration; break;
-                case ControlLevel::BRAKE_1:    target_accel = constraints_.min_acceleration * (1.0 / 3.0); break;
-                case ControlLevel::BRAKE_2:    target_accel = constraints_.min_acceleration * (2.0 / 3.0); break;
-                case ControlLevel::BRAKE_3:    target_accel = constraints_.min_acceleration; break;
-            }
+void TrainController::setJerkGear(int gear) {
+    planner_.setJerkGear(gear);
+}
 
-            // --- 新增的修复逻辑 ---
-            // 如果当前速度为0或更小，并且目标加速度为负（即正在制动），
-            // 那么就强制将目标加速度设为0，防止列车后退。
-            if (state_.velocity <= 1e-6 && target_accel < 0.0) { // 使用一个小的阈值1e-6防止浮点数误差
-                target_accel = 0.0;
-            }
+void TrainController::setDrivingProfile(std::shared_ptr<const DrivingProfile> profile) {
+    driving_profile_ = (profile && !profile->empty()) ? std::move(profile) : nullptr;
+    select_kernels();
+}
 
-            planner_.setTargetAcceleration(target_accel);
-            planner_.update_for_acceleration(dt, state_);
-        }
-            break;
+void TrainController::select_kernels() {
+    coast_kernel_ = MotionPlanner::selectKernel(ControlPolicy::ACCELERATION_TARGET);
+    if (m_control_mode == ControlMode::AUTOMATIC) {
+        mode_update_ = driving_profile_ ? &TrainController::update_profile : &TrainController::update_automatic;
+        planner_kernel_ = MotionPlanner::selectKernel(ControlPolicy::VELOCITY_TARGET);
+    } else {
+        mode_update_ = &TrainController::update_manual;
+        planner_kernel_ = MotionPlanner::selectKernel(ControlPolicy::ACCELERATION_TARGET);
     }
+}
 
-    print_state();
+void TrainController::update(double dt) {
+    const double resistance_accel = compute_resistance_acceleration();
+    planner_.setResistanceAcceleration(resistance_accel);
 
-    if (train_state_ == TrainState::STOPPED && state_.position > 1.0) {
+    (this->*mode_update_)(dt, resistance_accel);
+
+    if (logging_enabled_) {
+        print_state();
+    }
+
+    // 到站对齐只属于自动模式；手动模式不维护自动驾驶状态，train_state_ 始终停留在 STOPPED
+    if (m_control_mode == ControlMode::AUTOMATIC && train_state_ == TrainState::STOPPED && state_.position > 1.0) {
+        stop_position_ = state_.position;
         state_.position = station_position_;
         state_.velocity = 0.0;
         state_.acceleration = 0.0;
@@ -93,30 +133,80 @@ void TrainController::update(double dt) {
     }
 }
 
+void TrainController::update_automatic(double dt, double /*resistance_accel*/) {
+    update_state_machine();
+    planner_kernel_(planner_, dt, state_);
+}
+
+void TrainController::update_manual(double dt, double resistance_accel) {
+    const LevelTarget& level = level_targets_[static_cast<int>(m_current_level)];
+    double target_accel = level.base + level.resistance_weight * resistance_accel;
+
+    // 如果当前速度为0或更小，并且目标加速度为负（即正在制动），
+    // 那么就强制将目标加速度设为0，防止列车后退。
+    if (state_.velocity <= 1e-6 && target_accel < 0.0) { // 使用一个小的阈值1e-6防止浮点数误差
+        target_accel = 0.0;
+    }
+
+    planner_.setTargetAcceleration(target_accel);
+    planner_kernel_(planner_, dt, state_);
+}
+
+void TrainController::update_profile(double dt, double /*resistance_accel*/) {
+    const DrivingProfile& profile = *driving_profile_;
+    const double distance_to_station = station_position_ - state_.position;
+    const size_t idx = profile.indexAt(state_.position);
+
+    if (train_state_ == TrainState::STOPPED && state_.position > 1.0) {
+        return; // 已到站
+    }
+    // 剖面最后一个区间内停稳即视为到站
+    if (state_.position > 1.0 && state_.velocity < 0.1 && (distance_to_station < 1.0 || idx + 2 >= profile.size())) {
+        if (logging_enabled_) std::cout << "\nTrain has stopped at the station.\n";
+        train_state_ = TrainState::STOPPED;
+        return;
+    }
+
+    const DrivingProfilePoint& point = profile.point(idx);
+    const double next_speed = profile.point(std::min(idx + 1, profile.size() - 1)).speed;
+    switch (point.regime) {
+        case DrivingRegime::COAST:
+            train_state_ = TrainState::COASTING;
+            planner_.setTargetAcceleration(0.0);
+            coast_kernel_(planner_, dt, state_);
+            return;
+        case DrivingRegime::TRACTION: train_state_ = TrainState::ACCELERATING; break;
+        case DrivingRegime::CRUISE:   train_state_ = TrainState::CRUISING; break;
+        case DrivingRegime::BRAKE:    train_state_ = TrainState::BRAKING; break;
+    }
+    planner_.setTargetVelocity(next_speed);
+    planner_kernel_(planner_, dt, state_);
+}
+
 void TrainController::update_state_machine() {
     double distance_to_station = station_position_ - state_.position;
     switch (train_state_) {
         case TrainState::STOPPED:
-            std::cout << "\nTrain is starting...\n";
+            if (logging_enabled_) std::cout << "\nTrain is starting...\n";
             train_state_ = TrainState::ACCELERATING;
             planner_.setTargetVelocity(constraints_.max_velocity);
             break;
         case TrainState::ACCELERATING:
             if (std::abs(state_.velocity - constraints_.max_velocity) < 0.1) {
-                std::cout << "\nReached max velocity. Now cruising.\n";
+                if (logging_enabled_) std::cout << "\nReached max velocity. Now cruising.\n";
                 train_state_ = TrainState::CRUISING;
             }
             break;
         case TrainState::CRUISING:
             if (distance_to_station < COASTING_BUFFER_DISTANCE) {
-                std::cout << "\nEntering coasting buffer. Preparing to stop.\n";
+                if (logging_enabled_) std::cout << "\nEntering coasting buffer. Preparing to stop.\n";
                 train_state_ = TrainState::COASTING;
                 planner_.setTargetVelocity(0.0);
             }
             break;
         case TrainState::COASTING:
             if (state_.velocity < 0.1 && distance_to_station < 1.0) {
-                 std::cout << "\nTrain has stopped at the station.\n";
+                 if (logging_enabled_) std::cout << "\nTrain has stopped at the station.\n";
                 train_state_ = TrainState::STOPPED;
             }
             break;
@@ -125,6 +215,11 @@ void TrainController::update_state_machine() {
     }
 }
 
+double TrainController::compute_resistance_acceleration() const {
+    const TrackProfilePoint profile = track_profile_ ? track_profile_->at(state_.position) : TrackProfilePoint{};
+    return ResistanceModel::totalAcceleration(resistance_coefficients_, state_.velocity, profile);
+}
+
 MotionConstraints TrainController::create_constraints_from_info(const TrainInfo& train_info) {
     MotionConstraints constraints;
     constraints.max_velocity = train_info.maxSpeed / 3.6;
@@ -155,4 +250,16 @@ void TrainController::printCurrentState() const {
 
 const KinematicState& TrainController::getCurrentState() const {
     return state_;
+}
+
+TrainState TrainController::getTrainState() const {
+    return train_state_;
+}
+
+double TrainController::getStationPosition() const {
+    return station_position_;
+}
+
+double TrainController::getStopPosition() const {
+    return stop_position_;
 }
\ No newline at end of file
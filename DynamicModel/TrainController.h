@@ -1,8 +1,11 @@
 #pragma once
 #include "MotionPlanner.h"
 #include "TestVehicle.h"
+#include "DrivingProfile.h"
+#include "TrajKit/TrackProfile.h"
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 // 自动驾驶状态
 enum class TrainState {
@@ -35,23 +38,45 @@ public:
         BRAKE_3
     };
 
-    TrainController(const TrainInfo& train_info, double track_length);
+    // track_profile 为空时按平直线路计算，仅考虑基本阻力
+    // enable_logging 为 false 时不打印状态、不写 simulation_log.dat（用于批量离线仿真）
+    TrainController(const TrainInfo& train_info, double track_length, const TrackProfile* track_profile = nullptr,
+                    bool enable_logging = true);
+    // 复制运动状态与控制设定；副本不打印、不写日志（用于在副本上预先推演轨迹）
+    TrainController(const TrainController& other);
+    TrainController& operator=(const TrainController&) = delete;
     ~TrainController();
 
     // --- 模式切换和控制接口 ---
     void setControlMode(ControlMode mode);
     void setControlLevel(ControlLevel level);
+    void setJerkGear(int gear); // 0: 低档, 1: 中档, 2: 高档（默认）
+    // 设置后自动模式按剖面的目标速度与工况运行，传入空指针恢复默认的 加速-巡航-惰行 模式
+    void setDrivingProfile(std::shared_ptr<const DrivingProfile> profile);
 
     // --- 核心更新函数 ---
     void update(double dt);
 
     // --- 数据获取接口 ---
     const KinematicState& getCurrentState() const;
+    TrainState getTrainState() const;
+    double getStationPosition() const;
+    // 最近一次自动停车时、对齐到车站之前的实际位置
+    double getStopPosition() const;
     void printCurrentState() const;
 
 private:
+    // 每周期通过成员函数指针分发，避免对模式/档位的嵌套分支
+    using ModeUpdate = void (TrainController::*)(double dt, double resistance_accel);
+
+    void update_automatic(double dt, double resistance_accel);
+    void update_manual(double dt, double resistance_accel);
+    void update_profile(double dt, double resistance_accel);
+    void select_kernels(); // 模式或驾驶剖面变化时重新选择
+
     void print_state() const;
     void update_state_machine(); // 自动驾驶的状态机
+    double compute_resistance_acceleration() const; // 基本阻力 + 坡道 + 曲线阻力
     static MotionConstraints create_constraints_from_info(const TrainInfo& train_info);
 
     // --- 状态变量 ---
@@ -63,9 +88,27 @@ private:
     MotionConstraints constraints_;
     MotionPlanner planner_;
 
+    ModeUpdate mode_update_ = &TrainController::update_automatic;
+    MotionPlanner::Kernel planner_kernel_ = nullptr;
+    MotionPlanner::Kernel coast_kernel_ = nullptr; // 剖面惰行工况使用的加速度内核
+    std::shared_ptr<const DrivingProfile> driving_profile_;
+
+    // 手动档位目标加速度 = base + resistance_weight * 阻力，构造时由约束折叠
+    struct LevelTarget {
+        double base;
+        double resistance_weight;
+    };
+    LevelTarget level_targets_[8];
+
     double track_length_;
     double station_position_;
 
+    double resistance_coefficients_[3];
+    const TrackProfile* track_profile_;
+    double stop_position_ = 0.0;
+
+    bool logging_enabled_;
+
     const double COASTING_BUFFER_DISTANCE = 500.0;
     mutable std::ofstream output_file_;
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "ConsistTrajectory.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+double clamp_center(double s_center, double train_length, double route_length) {
+    const double half_len = train_length * 0.5;
+    const double min_s = half_len;
+    const double max_s = std::max(half_len, route_length - half_len);
+    return std::clamp(s_center, min_s, max_s);
+}
+} // namespace
+
+ConsistTrajectory::ConsistTrajectory(const Route& route, std::vector<ConsistUser> users, double train_length)
+    : route_(route), users_(std::move(users)), train_length_(train_length) {
+    if (users_.size() > MAX_CONSIST_USERS) {
+        throw std::runtime_error("编组用户数超过上限 " + std::to_string(MAX_CONSIST_USERS));
+    }
+    order_.resize(users_.size());
+    for (size_t i = 0; i < order_.size(); ++i) {
+        order_[i] = i;
+    }
+    std::stable_sort(order_.begin(), order_.end(), [this](size_t lhs, size_t rhs) {
+        return users_[lhs].offset_m > users_[rhs].offset_m;
+    });
+    distances_.resize(users_.size());
+    samples_.resize(users_.size());
+}
+
+std::vector<ConsistUser> ConsistTrajectory::resolve(const SimulatorConfiguration& config) {
+    if (!config.consist_users.empty()) {
+        return config.consist_users;
+    }
+    std::vector<ConsistUser> users;
+    users.push_back({config.trajectory_ID, config.trajectory_type, 0.0});
+    if (config.enable_second_user) {
+        users.push_back({config.trajectory_ID_user2, config.trajectory_type_user2, config.test_vehicle.trainLong});
+    }
+    return users;
+}
+
+size_t ConsistTrajectory::write(const KinematicState& state, double trajectory_time, unsigned long long sequence,
+                                unsigned char* payload) {
+    const double route_length = route_.getTotalDistance();
+    const double half_len = train_length_ * 0.5;
+    const double clamped_center_s = clamp_center(state.position, train_length_, route_length);
+    const bool clamped = clamped_center_s != state.position;
+
+    const double tangential_speed = clamped ? 0.0 : state.velocity;
+    const double tangential_acc = clamped ? 0.0 : state.acceleration;
+    const double tangential_jerk = clamped ? 0.0 : state.jerk;
+
+    const double s_head = std::min(route_length, clamped_center_s + half_len);
+    for (size_t k = 0; k < order_.size(); ++k) {
+        distances_[k] = std::clamp(s_head - users_[order_[k]].offset_m, 0.0, route_length);
+    }
+    route_.evaluateBatch(distances_.data(), distances_.size(),
+                         tangential_speed, tangential_acc, tangential_jerk, samples_.data());
+
+    for (size_t k = 0; k < order_.size(); ++k) {
+        const size_t index = order_[k];
+        const RouteSample& sample = samples_[k];
+        TrajectoryData user_data{};
+        user_data.trajectory_data_seq_num = sequence;
+        user_data.trajectory_time = trajectory_time;
+        user_data.trajectory_id = static_cast<unsigned int>(users_[index].trajectory_id);
+        user_data.trajectory_type = static_cast<unsigned int>(users_[index].trajectory_type);
+        user_data.user_pos_x = sample.position.x; user_data.user_pos_y = sample.position.y; user_data.user_pos_z = sample.position.z;
+        user_data.user_vel_x = sample.velocity.x; user_data.user_vel_y = sample.velocity.y; user_data.user_vel_z = sample.velocity.z;
+        user_data.user_acc_x = sample.acceleration.x; user_data.user_acc_y = sample.acceleration.y; user_data.user_acc_z = sample.acceleration.z;
+        user_data.user_jerk_x = sample.jerk.x; user_data.user_jerk_y = sample.jerk.y; user_data.user_jerk_z = sample.jerk.z;
+        TrajectoryDataLayout::write(user_data, payload + index * TrajectoryDataLayout::size);
+    }
+    return payload_size();
+}
+
+void ConsistTrajectory::initial_users(StartUserParams* out) const {
+    const double route_length = route_.getTotalDistance();
+    const double s_center0 = clamp_center(0.0, train_length_, route_length);
+    const double s_head0 = std::min(route_length, s_center0 + train_length_ * 0.5);
+
+    std::vector<double> distances(users_.size());
+    std::vector<RouteSample> samples(users_.size());
+    for (size_t i = 0; i < users_.size(); ++i) {
+        distances[i] = std::clamp(s_head0 - users_[i].offset_m, 0.0, route_length);
+    }
+    route_.evaluateBatch(distances.data(), distances.size(), 0.0, 0.0, 0.0, samples.data());
+
+    for (size_t i = 0; i < users_.size(); ++i) {
+        out[i] = StartUserParams{};
+        out[i].trajectory_id = static_cast<unsigned int>(users_[i].trajectory_id);
+        out[i].trajectory_type = static_cast<unsigned int>(users_[i].trajectory_type);
+        out[i].initial_user_pos_x = samples[i].position.x;
+        out[i].initial_user_pos_y = samples[i].position.y;
+        out[i].initial_user_pos_z = samples[i].position.z;
+    }
+}
+
+void ConsistTrajectory::set_sequence(unsigned char* payload, size_t user_count, unsigned long long sequence) {
+    for (size_t i = 0; i < user_count; ++i) {
+        TrajectoryDataLayout::set<&TrajectoryData::trajectory_data_seq_num>(payload + i * TrajectoryDataLayout::size, sequence);
+    }
+}
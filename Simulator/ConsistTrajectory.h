@@ -0,0 +1,52 @@
+//
+// Created by fyh on 25-8-23.
+//
+
+#ifndef CONSISTTRAJECTORY_H
+#define CONSISTTRAJECTORY_H
+#pragma once
+
+#include "SimulatorConfiguration.h"
+#include "DynamicModel/KinematicState.h"
+#include "TrainCommunicator/Protocol.h"
+#include "TrajKit/Route.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 把列车一维运动状态换算为编组各用户的轨迹数据块。
+ *
+ * 列车中心限制在线路内，车头走行距离减去各用户偏移即为用户位置；全部用户按走行距离升序
+ * 一次批量求值，再按配置顺序写入帧负载（多用户包是单用户包的直接拼接）。
+ * 实时仿真与离线批量运行共用此换算，保证两者输出逐字节一致。非线程安全。
+ */
+class ConsistTrajectory {
+public:
+    // route 须在本对象之后销毁；用户数超过 MAX_CONSIST_USERS 时抛出 std::runtime_error
+    ConsistTrajectory(const Route& route, std::vector<ConsistUser> users, double train_length);
+
+    // consist_users 为空时按 V2.4 单/双用户设置换算：车头一个用户，双用户时车尾再加一个
+    static std::vector<ConsistUser> resolve(const SimulatorConfiguration& config);
+
+    const std::vector<ConsistUser>& users() const { return users_; }
+    size_t user_count() const { return users_.size(); }
+    size_t payload_size() const { return users_.size() * TrajectoryDataLayout::size; }
+
+    // 写入一帧的全部用户块（各用户序号均为 sequence），返回负载字节数
+    size_t write(const KinematicState& state, double trajectory_time, unsigned long long sequence, unsigned char* payload);
+    // 发车前静止状态下各用户的 START 参数，out 至少容纳 user_count() 个
+    void initial_users(StartUserParams* out) const;
+    // 改写已生成负载中各用户的序号；序号按实际发出的帧编号时在发送前调用
+    static void set_sequence(unsigned char* payload, size_t user_count, unsigned long long sequence);
+
+private:
+    const Route& route_;
+    std::vector<ConsistUser> users_;
+    double train_length_;
+    // 按走行距离升序排列的用户下标（偏移越大越靠后），批量求值时共享样条段定位
+    std::vector<size_t> order_;
+    std::vector<double> distances_;
+    std::vector<RouteSample> samples_;
+};
+
+#endif //CONSISTTRAJECTORY_H
@@ -0,0 +1,110 @@
+//
+// Created by fyh on 25-8-13.
+//
+
+#ifndef CONTROLCOMMANDQUEUE_H
+#define CONTROLCOMMANDQUEUE_H
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 由API线程投递、定时器线程在每个周期开始时执行的控制指令
+struct ControlCommand {
+    enum class Type : uint8_t {
+        SET_MODE,
+        SET_LEVEL
+    };
+
+    Type type = Type::SET_MODE;
+    int value = 0;                 // ControlMode / ControlLevel 的整数值
+    long long enqueue_time_ns = 0; // 投递时刻 (steady_clock)
+
+    static long long now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+// 指令从投递到生效的延迟统计，由定时器线程写入
+struct CommandLatencyStats {
+    unsigned long long applied_count = 0;
+    unsigned long long dropped_count = 0;
+    long long last_latency_ns = 0;
+    long long max_latency_ns = 0;
+    long long total_latency_ns = 0;
+};
+
+/**
+ * @brief 有界多生产者/单消费者无锁队列（基于序号的环形缓冲）。
+ *
+ * 任意线程都可以 push，仅定时器线程调用 pop。两端都不加锁、不分配内存，
+ * 队列满时 push 返回 false，不会阻塞调用者。
+ */
+class ControlCommandQueue {
+public:
+    static constexpr size_t CAPACITY = 64; // 必须为 2 的幂
+
+    ControlCommandQueue() {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ControlCommandQueue(const ControlCommandQueue&) = delete;
+    ControlCommandQueue& operator=(const ControlCommandQueue&) = delete;
+
+    // 生产者：可被多个线程并发调用
+    bool push(const ControlCommand& command) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & MASK];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 队列已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->command = command;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：只能由单一线程调用
+    bool pop(ControlCommand& command) {
+        Cell* cell = &cells_[dequeue_pos_ & MASK];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(dequeue_pos_ + 1) < 0) {
+            return false; // 队列为空
+        }
+        command = cell->command;
+        cell->sequence.store(dequeue_pos_ + CAPACITY, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "CAPACITY must be a power of two");
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        ControlCommand command;
+    };
+
+    std::array<Cell, CAPACITY> cells_;
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;
+};
+
+#endif //CONTROLCOMMANDQUEUE_H
@@ -0,0 +1,217 @@
+#include "EnergyOptimizer.h"
+#include "WorkStealingPool.h"
+#include "DynamicModel/ResistanceModel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr int REGIME_COUNT = 4;
+
+// 离散网格与车辆参数，所有 λ 迭代共享
+struct Grid {
+    std::vector<double> distances;              // s_0 .. s_N
+    std::vector<TrackProfilePoint> profiles;    // 各区间起点的线路剖面
+    size_t speed_count = 0;                     // 速度网格点数 M+1
+    double speed_step = 0.0;
+    double max_speed = 0.0;
+    double max_accel = 0.0;
+    double min_accel = 0.0;
+    double resistance[3] = {0.0, 0.0, 0.0};
+};
+
+struct Transition {
+    bool feasible = false;
+    double next_speed = 0.0;
+    double time = 0.0;
+    double energy = 0.0;
+};
+
+// 在区间 [s_i, s_i + ds] 上以工况 regime 运行一步
+Transition transit(const Grid& grid, size_t stage, double speed, DrivingRegime regime) {
+    Transition t;
+    const double ds = grid.distances[stage + 1] - grid.distances[stage];
+    const double resistance = ResistanceModel::totalAcceleration(grid.resistance, speed, grid.profiles[stage]);
+
+    double applied = 0.0;
+    switch (regime) {
+        case DrivingRegime::TRACTION: applied = grid.max_accel; break;
+        case DrivingRegime::CRUISE:   applied = std::clamp(resistance, grid.min_accel, grid.max_accel); break;
+        case DrivingRegime::COAST:    applied = 0.0; break;
+        case DrivingRegime::BRAKE:    applied = grid.min_accel; break;
+    }
+
+    double v2 = speed * speed + 2.0 * (applied - resistance) * ds;
+    if (v2 < 0.0) {
+        if (regime != DrivingRegime::BRAKE) {
+            return t; // 区间内停车，无法到达下一网格点
+        }
+        v2 = 0.0; // 制动到恰好在下一点停车
+    }
+    double next_speed = std::min(std::sqrt(v2), grid.max_speed);
+    if (speed + next_speed <= 0.0) {
+        return t;
+    }
+
+    // 限速截断或制动提前停车时，按实际速度变化反推所需的牵引/制动力
+    applied = (next_speed * next_speed - speed * speed) / (2.0 * ds) + resistance;
+
+    t.feasible = true;
+    t.next_speed = next_speed;
+    t.time = 2.0 * ds / (speed + next_speed);
+    t.energy = std::max(applied, 0.0) * ds;
+    return t;
+}
+
+// 在速度网格上线性插值价值函数
+double interpolate(const std::vector<double>& values, const Grid& grid, double speed) {
+    const double x = speed / grid.speed_step;
+    const auto j0 = std::min(static_cast<size_t>(x), grid.speed_count - 1);
+    if (j0 + 1 >= grid.speed_count) {
+        return values[grid.speed_count - 1];
+    }
+    const double f = x - static_cast<double>(j0);
+    const double v0 = values[j0], v1 = values[j0 + 1];
+    if (v0 == INF || v1 == INF) {
+        return f < 0.5 ? v0 : v1;
+    }
+    return v0 + f * (v1 - v0);
+}
+
+struct Rollout {
+    std::vector<DrivingProfilePoint> points;
+    double time = 0.0;
+    double energy = 0.0;
+};
+
+class Solver {
+public:
+    Solver(const Grid& grid, WorkStealingPool& pool)
+        : grid_(grid), pool_(pool),
+          policy_((grid.distances.size() - 1) * grid.speed_count, static_cast<uint8_t>(DrivingRegime::TRACTION)) {}
+
+    // 对给定 λ 做逆向动态规划，再从起点正向展开得到剖面
+    Rollout solve(double lambda) {
+        const size_t stages = grid_.distances.size() - 1;
+        const size_t m = grid_.speed_count;
+        std::vector<double> next(m, INF), current(m, INF);
+        next[0] = 0.0; // 终点必须停车
+
+        for (size_t i = stages; i-- > 0;) {
+            pool_.parallel_for(0, m, [&, i](size_t j) {
+                const double speed = static_cast<double>(j) * grid_.speed_step;
+                double best = INF;
+                uint8_t best_regime = static_cast<uint8_t>(DrivingRegime::TRACTION);
+                for (int r = 0; r < REGIME_COUNT; ++r) {
+                    const Transition t = transit(grid_, i, speed, static_cast<DrivingRegime>(r));
+                    if (!t.feasible) continue;
+                    const double cost = t.energy + lambda * t.time + interpolate(next, grid_, t.next_speed);
+                    if (cost < best) {
+                        best = cost;
+                        best_regime = static_cast<uint8_t>(r);
+                    }
+                }
+                current[j] = best;
+                policy_[i * m + j] = best_regime;
+            }, 16);
+            std::swap(current, next);
+        }
+        return rollout();
+    }
+
+private:
+    Rollout rollout() const {
+        const size_t stages = grid_.distances.size() - 1;
+        Rollout result;
+        result.points.reserve(stages + 1);
+
+        double speed = 0.0;
+        for (size_t i = 0; i < stages; ++i) {
+            const auto j = std::min(static_cast<size_t>(std::lround(speed / grid_.speed_step)), grid_.speed_count - 1);
+            auto regime = static_cast<DrivingRegime>(policy_[i * grid_.speed_count + j]);
+            Transition t = transit(grid_, i, speed, regime);
+            if (!t.feasible) {
+                regime = DrivingRegime::TRACTION;
+                t = transit(grid_, i, speed, regime);
+            }
+            result.points.push_back({grid_.distances[i], speed, regime});
+            result.time += t.time;
+            result.energy += t.energy;
+            speed = t.next_speed;
+        }
+        result.points.push_back({grid_.distances.back(), speed, DrivingRegime::BRAKE});
+        return result;
+    }
+
+    const Grid& grid_;
+    WorkStealingPool& pool_;
+    std::vector<uint8_t> policy_;
+};
+} // namespace
+
+EnergyOptimizer::EnergyOptimizer(const Route& route, const TrainInfo& train_info, EnergyOptimizerSettings settings)
+    : route_(route), train_info_(train_info), settings_(settings) {}
+
+EnergyOptimizationResult EnergyOptimizer::optimize(double target_trip_time) const {
+    Grid grid;
+    const double length = route_.getTotalDistance();
+    const auto stages = std::max<size_t>(1, static_cast<size_t>(std::ceil(length / settings_.distance_step)));
+    grid.distances.reserve(stages + 1);
+    grid.profiles.reserve(stages);
+    for (size_t i = 0; i <= stages; ++i) {
+        const double s = std::min(static_cast<double>(i) * settings_.distance_step, length);
+        grid.distances.push_back(s);
+        if (i < stages) {
+            grid.profiles.push_back(route_.getTrackProfile().at(s));
+        }
+    }
+    grid.max_speed = train_info_.maxSpeed / 3.6;
+    const auto speed_intervals = std::max<size_t>(1, static_cast<size_t>(std::ceil(grid.max_speed / settings_.speed_step)));
+    grid.speed_count = speed_intervals + 1;
+    grid.speed_step = grid.max_speed / static_cast<double>(speed_intervals);
+    grid.max_accel = train_info_.tractionAcceleration;
+    grid.min_accel = train_info_.brakingAcceleration;
+    for (int k = 0; k < 3; ++k) {
+        grid.resistance[k] = train_info_.resistanceCoefficients[k];
+    }
+
+    WorkStealingPool pool(settings_.thread_count);
+    Solver solver(grid, pool);
+
+    EnergyOptimizationResult result;
+    auto accept = [&](const Rollout& rollout, double lambda) {
+        result.profile = DrivingProfile(rollout.points, settings_.distance_step);
+        result.trip_time = rollout.time;
+        result.traction_energy = rollout.energy;
+        result.time_multiplier = lambda;
+        result.meets_target = std::abs(rollout.time - target_trip_time) <= settings_.time_tolerance;
+    };
+
+    // 运行时分随 λ 单调递减，在对数尺度上二分
+    double lo = 1e-4, hi = 1e4;
+    const Rollout fastest = solver.solve(hi);
+    if (fastest.time > target_trip_time) {
+        accept(fastest, hi);
+        return result;
+    }
+    accept(fastest, hi);
+
+    for (int iter = 0; iter < settings_.max_iterations; ++iter) {
+        const double mid = std::sqrt(lo * hi);
+        const Rollout rollout = solver.solve(mid);
+        if (rollout.time <= target_trip_time) {
+            accept(rollout, mid); // 满足时分约束的剖面中能耗最低者
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+        if (result.meets_target || hi / lo < 1.0 + 1e-6) {
+            break;
+        }
+    }
+    result.meets_target = result.trip_time <= target_trip_time + settings_.time_tolerance;
+    return result;
+}
@@ -0,0 +1,53 @@
+//
+// Created by fyh on 25-8-15.
+//
+
+#ifndef ENERGYOPTIMIZER_H
+#define ENERGYOPTIMIZER_H
+#pragma once
+
+#include "DynamicModel/DrivingProfile.h"
+#include "DynamicModel/TestVehicle.h"
+#include "TrajKit/Route.h"
+#include <cstddef>
+
+struct EnergyOptimizerSettings {
+    double distance_step = 50.0;  // 里程网格间隔 (m)
+    double speed_step = 0.25;     // 速度网格间隔 (m/s)
+    double time_tolerance = 1.0;  // 与目标运行时分的允许偏差 (s)
+    int max_iterations = 60;      // 时间乘子二分的最大次数
+    size_t thread_count = 0;      // 0 表示使用全部核心
+};
+
+struct EnergyOptimizationResult {
+    DrivingProfile profile;
+    double trip_time = 0.0;       // 剖面对应的运行时分 (s)
+    double traction_energy = 0.0; // 单位质量牵引能耗 (J/kg)
+    double time_multiplier = 0.0; // 最终的时间乘子 λ
+    bool meets_target = false;    // 是否在容差内满足目标时分
+};
+
+/**
+ * @brief 节能驾驶剖面优化器。
+ *
+ * 在 里程 × 速度 离散网格上做逆向动态规划，每个里程区间在 牵引/恒速/惰行/制动
+ * 中选择工况，代价为 牵引能耗 + λ·运行时间；对 λ 二分使运行时分逼近目标。
+ * 同一里程层内各速度状态相互独立，在工作窃取线程池上并行求解。
+ */
+class EnergyOptimizer {
+public:
+    EnergyOptimizer(const Route& route, const TrainInfo& train_info, EnergyOptimizerSettings settings = {});
+
+    /**
+     * @param target_trip_time 目标运行时分 (s)
+     * @return 优化结果；目标不可达时返回最快剖面且 meets_target 为 false
+     */
+    EnergyOptimizationResult optimize(double target_trip_time) const;
+
+private:
+    const Route& route_;
+    TrainInfo train_info_;
+    EnergyOptimizerSettings settings_;
+};
+
+#endif //ENERGYOPTIMIZER_H
@@ -0,0 +1,154 @@
+#include "FeedbackTracker.h"
+#include <chrono>
+
+FeedbackTracker::FeedbackTracker() {
+    reset();
+}
+
+void FeedbackTracker::reset() {
+    std::lock_guard<std::mutex> frame_lock(frame_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(command_mutex_);
+        pending_ = {};
+        next_pending_ = 0;
+    }
+    for (size_t i = 0; i < SEQ_WINDOW; ++i) {
+        seq_tag_[i].store(0, std::memory_order_relaxed);
+        sent_ns_[i].store(0, std::memory_order_relaxed);
+    }
+    last_sent_seq_.store(0, std::memory_order_relaxed);
+    round_trip_.reset();
+    replies_ = 0;
+    unmatched_replies_ = 0;
+    stream_feedback_ = 0;
+    malformed_ = 0;
+    last_acked_seq_ = 0;
+    peer_received_ = 0;
+    stale_feedback_ = 0;
+    untimed_feedback_ = 0;
+}
+
+void FeedbackTracker::command_sent(uint64_t command_word, long long now_ns) {
+    std::lock_guard<std::mutex> lock(command_mutex_);
+    // 同一指令字重发时覆盖旧记录，否则占用下一个槽位
+    PendingCommand* slot = nullptr;
+    for (PendingCommand& pending : pending_) {
+        if (pending.command_word == command_word) {
+            slot = &pending;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        slot = &pending_[next_pending_];
+        next_pending_ = (next_pending_ + 1) % MAX_PENDING;
+    }
+    slot->command_word = command_word;
+    slot->sent_ns = now_ns;
+    slot->reply = CommandReply{};
+    slot->reply.command_word = command_word;
+}
+
+void FeedbackTracker::trajectory_sent(unsigned long long seq, long long now_ns) {
+    const size_t index = seq % SEQ_WINDOW;
+    // 先作废标签再写时刻，接收线程据此发现与覆盖重叠的读取
+    seq_tag_[index].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    sent_ns_[index].store(now_ns, std::memory_order_relaxed);
+    seq_tag_[index].store(seq, std::memory_order_release);
+    last_sent_seq_.store(seq, std::memory_order_relaxed);
+}
+
+void FeedbackTracker::on_frame(const void* payload, size_t payload_size, long long now_ns) {
+    std::lock_guard<std::mutex> lock(frame_mutex_);
+    if (payload_size < AckMessageLayout::size) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const AckMessage ack = AckMessageLayout::read(static_cast<const unsigned char*>(payload));
+    if (ack.command_word == COMMAND_STREAM_FEEDBACK) {
+        on_stream_feedback(ack, now_ns);
+    } else {
+        on_command_reply(ack, now_ns);
+    }
+}
+
+void FeedbackTracker::on_command_reply(const AckMessage& ack, long long now_ns) {
+    {
+        std::lock_guard<std::mutex> lock(command_mutex_);
+        PendingCommand* match = nullptr;
+        for (PendingCommand& pending : pending_) {
+            if (pending.command_word == ack.command_word && pending.command_word != 0 && !pending.reply.replied) {
+                match = &pending;
+                break;
+            }
+        }
+        if (match == nullptr) {
+            unmatched_replies_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        match->reply.replied = true;
+        match->reply.status = ack.status;
+        match->reply.latency_ns = now_ns - match->sent_ns;
+    }
+    replies_.fetch_add(1, std::memory_order_relaxed);
+    reply_cond_.notify_all();
+}
+
+void FeedbackTracker::on_stream_feedback(const AckMessage& ack, long long now_ns) {
+    stream_feedback_.fetch_add(1, std::memory_order_relaxed);
+    peer_received_.store(ack.received_count, std::memory_order_relaxed);
+    if (ack.last_seq_num <= last_acked_seq_.load(std::memory_order_relaxed)) {
+        stale_feedback_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    last_acked_seq_.store(ack.last_seq_num, std::memory_order_relaxed);
+
+    // 前后两次读取标签，确认读到的发出时刻属于该序号且未被发送线程覆盖
+    const size_t index = ack.last_seq_num % SEQ_WINDOW;
+    if (seq_tag_[index].load(std::memory_order_acquire) != ack.last_seq_num) {
+        untimed_feedback_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const long long sent_ns = sent_ns_[index].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (seq_tag_[index].load(std::memory_order_relaxed) != ack.last_seq_num) {
+        untimed_feedback_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    round_trip_.record(now_ns - sent_ns);
+}
+
+bool FeedbackTracker::wait_for_reply(uint64_t command_word, int timeout_ms, CommandReply& reply) {
+    std::unique_lock<std::mutex> lock(command_mutex_);
+    const PendingCommand* target = nullptr;
+    for (const PendingCommand& pending : pending_) {
+        if (pending.command_word == command_word) {
+            target = &pending;
+            break;
+        }
+    }
+    if (target == nullptr) {
+        return false;
+    }
+    const bool replied = reply_cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [target] {
+        return target->reply.replied;
+    });
+    reply = target->reply;
+    return replied;
+}
+
+FeedbackStats FeedbackTracker::stats() const {
+    FeedbackStats stats;
+    stats.replies = replies_.load(std::memory_order_relaxed);
+    stats.unmatched_replies = unmatched_replies_.load(std::memory_order_relaxed);
+    stats.stream_feedback = stream_feedback_.load(std::memory_order_relaxed);
+    stats.malformed = malformed_.load(std::memory_order_relaxed);
+    stats.last_sent_seq = last_sent_seq_.load(std::memory_order_relaxed);
+    stats.last_acked_seq = last_acked_seq_.load(std::memory_order_relaxed);
+    stats.peer_received = peer_received_.load(std::memory_order_relaxed);
+    stats.peer_lost = stats.last_acked_seq > stats.peer_received ? stats.last_acked_seq - stats.peer_received : 0;
+    stats.stale_feedback = stale_feedback_.load(std::memory_order_relaxed);
+    stats.untimed_feedback = untimed_feedback_.load(std::memory_order_relaxed);
+    stats.round_trip = round_trip_.summary();
+    return stats;
+}
@@ -0,0 +1,110 @@
+//
+// Created by fyh on 25-8-20.
+//
+
+#ifndef FEEDBACKTRACKER_H
+#define FEEDBACKTRACKER_H
+#pragma once
+
+#include "TickHistogram.h"
+#include "TrainCommunicator/Protocol.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 一条指令的应答情况
+struct CommandReply {
+    uint64_t command_word = 0;
+    bool replied = false;
+    uint32_t status = 0;          // 模拟器返回的状态码，0 表示接受
+    long long latency_ns = 0;     // 发出指令到收到应答的时间
+};
+
+// 回执与数据流反馈统计，可在任意线程读取
+struct FeedbackStats {
+    unsigned long long replies = 0;             // 与已发指令匹配上的应答数
+    unsigned long long unmatched_replies = 0;   // 没有对应指令（或重复）的应答数
+    unsigned long long stream_feedback = 0;     // 收到的数据流反馈报文数
+    unsigned long long malformed = 0;           // 帧头合法但载荷无法解析的报文
+    unsigned long long last_sent_seq = 0;       // 本端已发出的最大轨迹序号
+    unsigned long long last_acked_seq = 0;      // 模拟器报告的最大轨迹序号
+    unsigned long long peer_received = 0;       // 模拟器报告的累计收包数
+    unsigned long long peer_lost = 0;           // last_acked_seq - peer_received（模拟器侧缺失的序号数）
+    unsigned long long stale_feedback = 0;      // 序号不增的反馈（乱序或重复）
+    unsigned long long untimed_feedback = 0;    // 序号已滑出时间窗口、无法计算往返时延的反馈
+    LatencySummary round_trip;                  // 轨迹帧发出到对应反馈到达的往返时延
+};
+
+/**
+ * @brief 解析模拟器回执（AckMessage），匹配指令应答并统计数据流的逐序号往返时延。
+ *
+ * 发送线程（包括定时器线程）只调用 trajectory_sent，每次仅两次原子写入，不加锁、不阻塞；
+ * on_frame 只在 UdpCommunicator 的接收线程中调用，与 reset 由互斥量串行化。指令应答很少，
+ * 用互斥量与条件变量支持 wait_for_reply。
+ */
+class FeedbackTracker {
+public:
+    // 记录发送时刻的序号窗口，反馈落后超过该数量的帧不再计算往返时延
+    static constexpr size_t SEQ_WINDOW = 4096;
+
+    FeedbackTracker();
+
+    // 清空统计，新一次仿真开始前（发送线程未运行时）调用；可与接收线程并发
+    void reset();
+
+    // 发出指令前调用，之后收到的同指令字应答与之匹配
+    void command_sent(uint64_t command_word, long long now_ns);
+
+    // 发送线程：记录轨迹序号的发出时刻
+    void trajectory_sent(unsigned long long seq, long long now_ns);
+
+    // 接收线程：处理一个帧头已校验的报文
+    void on_frame(const void* payload, size_t payload_size, long long now_ns);
+
+    /**
+     * @brief 等待最近一次发出的 command_word 的应答。
+     * @return 超时前收到应答时返回 true，reply 为应答内容
+     */
+    bool wait_for_reply(uint64_t command_word, int timeout_ms, CommandReply& reply);
+
+    FeedbackStats stats() const;
+
+private:
+    struct PendingCommand {
+        uint64_t command_word = 0;
+        long long sent_ns = 0;
+        CommandReply reply;
+    };
+    static constexpr size_t MAX_PENDING = 4;
+
+    void on_command_reply(const AckMessage& ack, long long now_ns);
+    void on_stream_feedback(const AckMessage& ack, long long now_ns);
+
+    // 串行化 on_frame 与 reset，避免重置与接收线程对直方图和计数的读改写交错；先于 command_mutex_ 加锁
+    std::mutex frame_mutex_;
+    mutable std::mutex command_mutex_;
+    std::condition_variable reply_cond_;
+    std::array<PendingCommand, MAX_PENDING> pending_{};
+    size_t next_pending_ = 0;
+
+    // 按 seq % SEQ_WINDOW 存放发出时刻；seq_tag_ 在时刻写入后发布，用于识别槽位是否被覆盖
+    std::array<std::atomic<unsigned long long>, SEQ_WINDOW> seq_tag_;
+    std::array<std::atomic<long long>, SEQ_WINDOW> sent_ns_;
+    std::atomic<unsigned long long> last_sent_seq_{0};
+
+    // 以下仅由接收线程（持有 frame_mutex_）写入
+    LatencyHistogram round_trip_;
+    std::atomic<unsigned long long> replies_{0};
+    std::atomic<unsigned long long> unmatched_replies_{0};
+    std::atomic<unsigned long long> stream_feedback_{0};
+    std::atomic<unsigned long long> malformed_{0};
+    std::atomic<unsigned long long> last_acked_seq_{0};
+    std::atomic<unsigned long long> peer_received_{0};
+    std::atomic<unsigned long long> stale_feedback_{0};
+    std::atomic<unsigned long long> untimed_feedback_{0};
+};
+
+#endif //FEEDBACKTRACKER_H
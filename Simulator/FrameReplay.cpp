@@ -0,0 +1,46 @@
+#include "FrameReplay.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+
+ReplayReport FrameReplayer::replay(UdpCommunicator& udp, const ReplayOptions& options,
+                                   const std::atomic<bool>* keep_running) {
+    ReplayReport report;
+    lateness_.reset();
+    const std::vector<CapturedFrame>& frames = capture_.frames();
+    if (frames.empty()) {
+        return report;
+    }
+
+    const bool paced = options.rate_scale > 0.0;
+    const long long first_ns = frames.front().timestamp_ns;
+    const long long start_ns = MillisecondTimer::now_ns();
+    for (const CapturedFrame& frame : frames) {
+        if (keep_running != nullptr && !keep_running->load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (frame.send_status != 0) {
+            ++report.frames_skipped;
+            continue;
+        }
+        long long deadline_ns = start_ns;
+        if (paced) {
+            deadline_ns += static_cast<long long>(static_cast<double>(frame.timestamp_ns - first_ns) / options.rate_scale);
+            MillisecondTimer::sleep_until_ns(deadline_ns, options.spin_window_ns);
+        }
+        const long long send_ns = MillisecondTimer::now_ns();
+        if (udp.send_frame(frame.data, frame.size).ok()) {
+            ++report.frames_sent;
+        } else {
+            ++report.send_failures;
+        }
+        if (paced) {
+            lateness_.record(send_ns - deadline_ns);
+        }
+    }
+
+    report.duration_sec = static_cast<double>(MillisecondTimer::now_ns() - start_ns) / 1e9;
+    if (report.duration_sec > 0.0) {
+        report.frames_per_sec = static_cast<double>(report.frames_sent + report.send_failures) / report.duration_sec;
+    }
+    report.lateness = lateness_.summary();
+    return report;
+}
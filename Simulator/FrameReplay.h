@@ -0,0 +1,50 @@
+//
+// Created by fyh on 25-8-21.
+//
+
+#ifndef FRAMEREPLAY_H
+#define FRAMEREPLAY_H
+#pragma once
+
+#include "TickHistogram.h"
+#include "TrainCommunicator/FrameCapture.h"
+#include "TrainCommunicator/UdpCommunicator.h"
+#include <atomic>
+
+struct ReplayOptions {
+    // 回放倍速：1 为原始节奏，2 为两倍速；0 表示不等待、尽快发送
+    double rate_scale = 1.0;
+    // 每个期望时刻前的忙等窗口 (ns)，高帧率（>1kHz）时用于消除 clock_nanosleep 的唤醒延迟
+    long long spin_window_ns = 50000;
+};
+
+struct ReplayReport {
+    unsigned long long frames_sent = 0;
+    unsigned long long send_failures = 0;
+    unsigned long long frames_skipped = 0; // 捕获时即发送失败、回放时跳过的帧
+    double duration_sec = 0.0;
+    double frames_per_sec = 0.0;
+    LatencySummary lateness;  // 实际发出时刻相对期望时刻的滞后
+};
+
+/**
+ * @brief 按捕获时间戳重放帧流。
+ *
+ * 第 i 帧的期望时刻为 start + (t_i - t_0) / rate_scale（绝对截止时间，误差不累积）；
+ * 帧直接从映射内存交给 UdpCommunicator::send_frame，不做拷贝。滞后时不补偿也不丢帧，
+ * 后续帧仍按各自的期望时刻发送。
+ */
+class FrameReplayer {
+public:
+    explicit FrameReplayer(const FrameCaptureReader& capture) : capture_(capture) {}
+
+    // 阻塞直到回放结束，keep_running 变为 false 时提前返回
+    ReplayReport replay(UdpCommunicator& udp, const ReplayOptions& options,
+                        const std::atomic<bool>* keep_running = nullptr);
+
+private:
+    const FrameCaptureReader& capture_;
+    LatencyHistogram lateness_;
+};
+
+#endif //FRAMEREPLAY_H
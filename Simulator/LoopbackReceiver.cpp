@@ -0,0 +1,227 @@
+#include "LoopbackReceiver.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+#include "TrainCommunicator/Protocol.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int RECEIVE_TIMEOUT_MS = 100;   // 检查停止标志的间隔
+constexpr size_t MAX_DATAGRAM = 65535;
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+void close_socket(SocketHandle sock) { closesocket(sock); }
+#else
+using SocketHandle = int;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+void close_socket(SocketHandle sock) { close(sock); }
+#endif
+} // namespace
+
+class LoopbackReceiver::SocketImpl {
+public:
+    SocketHandle sock = INVALID_SOCKET_HANDLE;
+
+    SocketImpl() {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            throw std::runtime_error("WSAStartup failed.");
+        }
+#endif
+    }
+
+    ~SocketImpl() {
+        if (sock != INVALID_SOCKET_HANDLE) {
+            close_socket(sock);
+        }
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    /**
+     * @brief 阻塞接收一个报文，最多等待 RECEIVE_TIMEOUT_MS。
+     * @return 报文长度；超时或出错返回 -1
+     */
+    long long receive(unsigned char* buffer, size_t capacity, sockaddr_in& peer, long long& arrival_ns) {
+#ifdef _WIN32
+        int peer_len = sizeof(peer);
+        const int bytes = recvfrom(sock, reinterpret_cast<char*>(buffer), static_cast<int>(capacity), 0,
+                                   reinterpret_cast<sockaddr*>(&peer), &peer_len);
+        arrival_ns = MillisecondTimer::now_ns();
+        return bytes;
+#else
+        iovec iov{buffer, capacity};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec))];
+        msghdr msg{};
+        msg.msg_name = &peer;
+        msg.msg_namelen = sizeof(peer);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        const ssize_t bytes = recvmsg(sock, &msg, 0);
+        arrival_ns = MillisecondTimer::now_ns();
+#if defined(SO_TIMESTAMPNS)
+        // 内核时间戳为 CLOCK_REALTIME，只用于计算间隔
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); bytes >= 0 && cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                arrival_ns = static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+            }
+        }
+#endif
+        return bytes;
+#endif
+    }
+};
+
+LoopbackReceiver::LoopbackReceiver(const LoopbackReceiverOptions& options)
+    : socket_(new SocketImpl()), options_(options) {
+    socket_->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket_->sock == INVALID_SOCKET_HANDLE) {
+        delete socket_;
+        throw std::runtime_error("Socket creation failed.");
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(options_.port));
+    if (inet_pton(AF_INET, options_.bind_ip.c_str(), &addr.sin_addr) <= 0
+        || bind(socket_->sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        delete socket_;
+        throw std::runtime_error("Failed to bind receiver to " + options_.bind_ip + ":" + std::to_string(options_.port));
+    }
+    sockaddr_in bound{};
+#ifdef _WIN32
+    int bound_len = sizeof(bound);
+#else
+    socklen_t bound_len = sizeof(bound);
+#endif
+    getsockname(socket_->sock, reinterpret_cast<sockaddr*>(&bound), &bound_len);
+    port_ = ntohs(bound.sin_port);
+
+#ifdef _WIN32
+    const DWORD timeout = RECEIVE_TIMEOUT_MS;
+    setsockopt(socket_->sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+    timeval timeout{0, RECEIVE_TIMEOUT_MS * 1000};
+    setsockopt(socket_->sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#if defined(SO_TIMESTAMPNS)
+    // 不支持时退回到用户态接收时刻
+    const int enable = 1;
+    setsockopt(socket_->sock, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+#endif
+#endif
+    if (options_.receive_buffer_bytes > 0) {
+        const int size = options_.receive_buffer_bytes;
+        setsockopt(socket_->sock, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+}
+
+LoopbackReceiver::~LoopbackReceiver() {
+    stop();
+    delete socket_;
+}
+
+void LoopbackReceiver::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&LoopbackReceiver::receive_loop, this);
+}
+
+void LoopbackReceiver::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool LoopbackReceiver::wait_for_stop(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return stop_cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return stop_received_; });
+}
+
+StreamReport LoopbackReceiver::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return validator_.report();
+}
+
+void LoopbackReceiver::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    validator_.reset();
+    stop_received_ = false;
+}
+
+void LoopbackReceiver::receive_loop() {
+    std::vector<unsigned char> buffer(MAX_DATAGRAM);
+    while (running_.load(std::memory_order_acquire)) {
+        sockaddr_in peer{};
+        long long arrival_ns = 0;
+        const long long bytes = socket_->receive(buffer.data(), buffer.size(), peer, arrival_ns);
+        if (bytes < 0) {
+            continue;
+        }
+
+        DatagramKind kind;
+        unsigned long long frames;
+        unsigned long long last_seq;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            kind = validator_.on_datagram(buffer.data(), static_cast<size_t>(bytes), arrival_ns);
+            frames = validator_.trajectory_frames();
+            last_seq = validator_.last_seq(0);
+            if (kind == DatagramKind::STOP) {
+                stop_received_ = true;
+            }
+        }
+        if (kind == DatagramKind::STOP) {
+            stop_cond_.notify_all();
+        }
+
+        if (options_.ack_commands && (kind == DatagramKind::START || kind == DatagramKind::STOP)) {
+            const uint64_t command_word =
+                StartCommandHeaderLayout::get<&StartCommand::command_word>(buffer.data() + NetworkFrameHeaderLayout::size);
+            send_ack(&peer, sizeof(peer), command_word, 0, 0);
+        } else if (options_.feedback_every > 0 && kind == DatagramKind::TRAJECTORY
+                   && frames % options_.feedback_every == 0) {
+            send_ack(&peer, sizeof(peer), COMMAND_STREAM_FEEDBACK, last_seq, frames);
+        }
+    }
+}
+
+void LoopbackReceiver::send_ack(const void* peer, size_t peer_size, unsigned long long command_word,
+                                unsigned long long last_seq, unsigned long long received) {
+    AckMessage ack{};
+    ack.command_word = command_word;
+    ack.status = 0;
+    ack.last_seq_num = last_seq;
+    ack.received_count = received;
+    ack.peer_time_ns = static_cast<uint64_t>(MillisecondTimer::now_ns());
+    unsigned char frame[NetworkFrameHeaderLayout::size + AckMessageLayout::size];
+    write_frame_header(frame, AckMessageLayout::size);
+    AckMessageLayout::write(ack, frame + NetworkFrameHeaderLayout::size);
+    sendto(socket_->sock, reinterpret_cast<const char*>(frame), static_cast<int>(sizeof(frame)), 0,
+           static_cast<const sockaddr*>(peer), static_cast<int>(peer_size));
+}
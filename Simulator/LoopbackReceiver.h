@@ -0,0 +1,70 @@
+//
+// Created by fyh on 25-8-20.
+//
+
+#ifndef LOOPBACKRECEIVER_H
+#define LOOPBACKRECEIVER_H
+#pragma once
+
+#include "StreamValidator.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct LoopbackReceiverOptions {
+    std::string bind_ip = "127.0.0.1";
+    int port = 9988;                  // 0 表示由系统分配，实际端口见 LoopbackReceiver::port()
+    bool ack_commands = false;        // 对 START/STOP 回复 AckMessage（状态 0）
+    unsigned feedback_every = 0;      // 每收到 N 个轨迹帧回复一次数据流反馈，0 表示不反馈
+    int receive_buffer_bytes = 0;     // SO_RCVBUF，0 表示使用系统默认值
+};
+
+/**
+ * @brief 本地信号模拟器替身：绑定端口接收仿真器报文，用 StreamValidator 校验并计时。
+ *
+ * 可选地按 AckMessage 扩展协议回复指令应答与数据流反馈，用于在没有真实模拟器的机器上
+ * 端到端验证发送、回执与时序。Linux 下使用内核接收时间戳 (SO_TIMESTAMPNS)，
+ * 到达间隔不受接收线程调度延迟影响。
+ */
+class LoopbackReceiver {
+public:
+    // 绑定失败时抛出 std::runtime_error
+    explicit LoopbackReceiver(const LoopbackReceiverOptions& options);
+    ~LoopbackReceiver();
+
+    LoopbackReceiver(const LoopbackReceiver&) = delete;
+    LoopbackReceiver& operator=(const LoopbackReceiver&) = delete;
+
+    void start();
+    void stop();
+
+    // 等待收到 STOP 指令；超时返回 false
+    bool wait_for_stop(int timeout_ms);
+
+    int port() const { return port_; }
+    StreamReport report() const;
+    // 清空统计（不影响接收线程）
+    void reset();
+
+private:
+    void receive_loop();
+    void send_ack(const void* peer, size_t peer_size, unsigned long long command_word,
+                  unsigned long long last_seq, unsigned long long received);
+
+    class SocketImpl;
+    SocketImpl* socket_;
+    LoopbackReceiverOptions options_;
+    int port_ = 0;
+
+    mutable std::mutex mutex_;        // 保护 validator_ 与 stop_received_
+    std::condition_variable stop_cond_;
+    StreamValidator validator_;
+    bool stop_received_ = false;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+#endif //LOOPBACKRECEIVER_H
@@ -0,0 +1,143 @@
+#include "ParameterSweep.h"
+#include "WorkStealingPool.h"
+#include "DynamicModel/TrainController.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <utility>
+
+namespace {
+double sample(const SweepRange& range, std::mt19937_64& rng) {
+    const double lo = std::min(range.min, range.max);
+    const double hi = std::max(range.min, range.max);
+    if (hi <= lo) {
+        return lo;
+    }
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+SweepMetricSummary summarize_metric(std::vector<double> values) {
+    SweepMetricSummary summary;
+    if (values.empty()) {
+        return summary;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    summary.mean = sum / static_cast<double>(values.size());
+    summary.min = values.front();
+    summary.max = values.back();
+    const auto p95_index = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(values.size()))) - 1;
+    summary.p95 = values[std::min(p95_index, values.size() - 1)];
+    return summary;
+}
+} // namespace
+
+ParameterSweep::ParameterSweep(const Route& route, SweepSpec spec)
+    : route_(route), spec_(std::move(spec)) {}
+
+std::vector<SweepRunResult> ParameterSweep::run(size_t thread_count) const {
+    std::vector<SweepRunResult> results(spec_.runs);
+    WorkStealingPool pool(thread_count);
+    for (size_t i = 0; i < spec_.runs; ++i) {
+        pool.submit([this, &results, i] {
+            results[i] = runSingle(i);
+        });
+    }
+    pool.wait_idle();
+    return results;
+}
+
+SweepRunResult ParameterSweep::runSingle(size_t run_index) const {
+    // 每次运行使用独立的随机流，结果与线程调度无关
+    std::mt19937_64 rng(spec_.seed ^ (0x9E3779B97F4A7C15ULL * (run_index + 1)));
+
+    SweepRunResult result;
+    result.run_index = run_index;
+    result.traction_acceleration = sample(spec_.traction_acceleration, rng);
+    result.braking_acceleration = sample(spec_.braking_acceleration, rng);
+    result.max_speed = sample(spec_.max_speed, rng);
+    result.train_length = sample(spec_.train_length, rng);
+    if (!spec_.jerk_gears.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, spec_.jerk_gears.size() - 1);
+        result.jerk_gear = spec_.jerk_gears[pick(rng)];
+    }
+
+    TrainInfo vehicle = spec_.base_vehicle;
+    vehicle.tractionAcceleration = result.traction_acceleration;
+    vehicle.brakingAcceleration = result.braking_acceleration;
+    vehicle.maxSpeed = result.max_speed;
+    vehicle.trainLong = result.train_length;
+
+    TrainController controller(vehicle, route_.getTotalDistance(), &route_.getTrackProfile(), false);
+    controller.setJerkGear(result.jerk_gear);
+
+    const double dt = spec_.time_step;
+    const auto max_steps = static_cast<size_t>(spec_.max_simulated_time / dt);
+    bool departed = false;
+
+    for (size_t step = 1; step <= max_steps; ++step) {
+        controller.update(dt);
+        const KinematicState& state = controller.getCurrentState();
+        result.max_jerk = std::max(result.max_jerk, std::abs(state.jerk));
+
+        const TrainState train_state = controller.getTrainState();
+        if (train_state != TrainState::STOPPED) {
+            departed = true;
+        } else if (departed) {
+            // 自动停车：控制器已将位置对齐到车站，误差取对齐前的位置
+            result.completed = true;
+            result.run_time = static_cast<double>(step) * dt;
+            result.stop_error = controller.getStopPosition() - controller.getStationPosition();
+            break;
+        }
+
+        // 在车站前停住且无法再触发停车判定
+        if (departed && train_state == TrainState::COASTING && state.velocity <= 0.0) {
+            result.completed = true;
+            result.run_time = static_cast<double>(step) * dt;
+            result.stop_error = state.position - controller.getStationPosition();
+            break;
+        }
+    }
+    return result;
+}
+
+SweepSummary ParameterSweep::summarize(const std::vector<SweepRunResult>& results) {
+    SweepSummary summary;
+    summary.runs = results.size();
+
+    std::vector<double> run_times, stop_errors, max_jerks;
+    for (const auto& r : results) {
+        if (!r.completed) {
+            continue;
+        }
+        ++summary.completed;
+        run_times.push_back(r.run_time);
+        stop_errors.push_back(r.stop_error);
+        max_jerks.push_back(r.max_jerk);
+    }
+    summary.run_time = summarize_metric(std::move(run_times));
+    summary.stop_error = summarize_metric(std::move(stop_errors));
+    summary.max_jerk = summarize_metric(std::move(max_jerks));
+    return summary;
+}
+
+void ParameterSweep::writeCsv(std::ostream& out, const std::vector<SweepRunResult>& results) {
+    out << "run,traction_accel,braking_accel,max_speed_kmh,train_length_m,jerk_gear,completed,run_time_s,stop_error_m,max_jerk\n";
+    for (const auto& r : results) {
+        out << r.run_index << ','
+            << r.traction_acceleration << ','
+            << r.braking_acceleration << ','
+            << r.max_speed << ','
+            << r.train_length << ','
+            << r.jerk_gear << ','
+            << (r.completed ? 1 : 0) << ','
+            << r.run_time << ','
+            << r.stop_error << ','
+            << r.max_jerk << '\n';
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Created by fyh on 25-8-14.
+//
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+#pragma once
+
+#include "DynamicModel/TestVehicle.h"
+#include "TrajKit/Route.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 均匀采样区间 [min, max]，min == max 时固定取值
+struct SweepRange {
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// 蒙特卡洛参数扫描配置
+struct SweepSpec {
+    TrainInfo base_vehicle{};                  // 未参与扫描的参数（阻力系数等）取自此处
+    SweepRange traction_acceleration{0.5, 1.0}; // m/s^2
+    SweepRange braking_acceleration{-1.0, -0.5}; // m/s^2
+    SweepRange max_speed{80.0, 160.0};         // km/h
+    SweepRange train_length{100.0, 400.0};     // m
+    std::vector<int> jerk_gears{0, 1, 2};      // 每次运行从中随机选择一个档位
+
+    size_t runs = 1000;
+    uint64_t seed = 1;
+    double time_step = 0.02;               // 仿真步长 (s)
+    double max_simulated_time = 4 * 3600.0; // 单次运行的仿真时长上限 (s)
+};
+
+// 单次运行的参数与结果
+struct SweepRunResult {
+    size_t run_index = 0;
+    double traction_acceleration = 0.0;
+    double braking_acceleration = 0.0;
+    double max_speed = 0.0;
+    double train_length = 0.0;
+    int jerk_gear = 2;
+
+    bool completed = false;   // 是否在时长上限内停车
+    double run_time = 0.0;    // 发车至停车的仿真时间 (s)
+    double stop_error = 0.0;  // 停车位置 - 车站位置 (m)，负值表示欠标
+    double max_jerk = 0.0;    // 全程最大 |jerk| (m/s^3)
+};
+
+struct SweepMetricSummary {
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p95 = 0.0;
+};
+
+struct SweepSummary {
+    size_t runs = 0;
+    size_t completed = 0;
+    SweepMetricSummary run_time;
+    SweepMetricSummary stop_error;
+    SweepMetricSummary max_jerk;
+};
+
+/**
+ * @brief 并行蒙特卡洛参数扫描引擎。
+ *
+ * 所有运行共享同一条只读 Route，每次运行构造独立的 TrainController，
+ * 以自动模式离线推进（不受墙钟限制、不写逐周期日志），只收集汇总指标。
+ */
+class ParameterSweep {
+public:
+    ParameterSweep(const Route& route, SweepSpec spec);
+
+    /**
+     * @brief 在工作窃取线程池上执行全部运行。
+     * @param thread_count 线程数，0 表示使用全部核心
+     * @return 按 run_index 排序的运行结果
+     */
+    std::vector<SweepRunResult> run(size_t thread_count = 0) const;
+
+    // 执行单次运行（参数由 seed 与 run_index 确定，与调度顺序无关）
+    SweepRunResult runSingle(size_t run_index) const;
+
+    static SweepSummary summarize(const std::vector<SweepRunResult>& results);
+    static void writeCsv(std::ostream& out, const std::vector<SweepRunResult>& results);
+
+private:
+    const Route& route_;
+    SweepSpec spec_;
+};
+
+#endif //PARAMETERSWEEP_H
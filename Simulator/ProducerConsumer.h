@@ -2,13 +2,16 @@
 #define PRODUCERCONSUMER_H
 
 #include "TrainCommunicator/MillisecondTimer.h" // 包含您提供的定时器头文件
+#include "SpscRingBuffer.h"
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <array>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <iostream>
+#include <concepts>
 
 /**
  * @brief 一个线程安全的队列模板类
@@ -44,6 +47,17 @@ public:
         return true;
     }
 
+    // 非阻塞弹出，队列为空时立即返回false
+    bool try_pop(T& value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        value = std::move(m_queue.front());
+        m_queue.pop();
+        return true;
+    }
+
     // 停止队列，唤醒所有等待的线程
     void stop() {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -70,8 +84,9 @@ private:
 /**
  * @brief 将生产者和消费者打包在一起的类
  * @tparam T 在生产者和消费者之间传递的数据类型
+ * @tparam Queue 队列后端，默认为无界加锁队列；也可使用 SpscRingBuffer 等有界无锁队列
  */
-template<typename T>
+template<typename T, typename Queue = ThreadSafeQueue<T>>
 class ProducerConsumer {
 public:
     /**
@@ -137,24 +152,154 @@ private:
     // 消费者线程的循环函数
     void consumer_loop() {
         std::cout << "Consumer thread started." << std::endl;
-        while (true) {
-            T data;
-            // pop会阻塞，直到有数据或队列被停止
-            if (!m_queue.pop(data)) {
-                // 如果pop返回false，说明队列已停止且为空，可以安全退出
-                break;
+        if constexpr (requires(T* out) { m_queue.pop_batch(out, size_t{}); }) {
+            // 支持批量出队的后端一次取出所有已就绪的元素，减少同步次数
+            std::array<T, CONSUMER_BATCH> batch;
+            while (const size_t count = m_queue.pop_batch(batch.data(), batch.size())) {
+                for (size_t i = 0; i < count; ++i) {
+                    m_consumer_task(std::move(batch[i]));
+                }
+            }
+        } else {
+            while (true) {
+                T data;
+                // pop会阻塞，直到有数据或队列被停止
+                if (!m_queue.pop(data)) {
+                    // 如果pop返回false，说明队列已停止且为空，可以安全退出
+                    break;
+                }
+                // 执行用户定义的回调
+                m_consumer_task(data);
             }
-            // 执行用户定义的回调
-            m_consumer_task(data);
         }
         std::cout << "Consumer thread finished." << std::endl;
     }
 
+    static constexpr size_t CONSUMER_BATCH = 16;
+
     MillisecondTimer m_producer_timer;
-    ThreadSafeQueue<T> m_queue;
+    Queue m_queue;
     std::thread m_consumer_thread;
     std::function<void(T)> m_consumer_task;
     std::atomic<bool> m_is_running{false};
 };
 
+/**
+ * @brief 预计算流水线：工作线程提前生产最多 depth 个数据，由调用方（通常是定时器线程）按需取走。
+ *
+ * 与 ProducerConsumer 相反，这里由工作线程尽早生产、定时器线程消费，使定时器线程只承担
+ * 轻量的取数与发送。每取走一个数据归还一个额度，工作线程随即生产下一个。
+ * @tparam T 在工作线程与消费线程之间传递的数据类型
+ * @tparam Queue 队列后端模板，实例化为 Queue<T>（数据）与 Queue<int>（额度）；使用有界队列时 depth 不得超过其容量
+ */
+template<typename T, template<typename> class Queue = ThreadSafeQueue>
+class LookaheadPipeline {
+public:
+    /**
+     * @param producer_task 用户定义的生产任务，按顺序填充下一个数据
+     */
+    explicit LookaheadPipeline(std::function<void(T&)> producer_task)
+        : m_producer_task(std::move(producer_task)) {}
+
+    ~LookaheadPipeline() {
+        stop();
+    }
+
+    LookaheadPipeline(const LookaheadPipeline&) = delete;
+    LookaheadPipeline& operator=(const LookaheadPipeline&) = delete;
+
+    void start(size_t depth) {
+        if (m_is_running) {
+            return;
+        }
+        m_ready.reset();
+        m_credits.reset();
+        for (size_t i = 0; i < depth; ++i) {
+            m_credits.push(1);
+        }
+        m_is_running = true;
+        m_worker_thread = std::thread(&LookaheadPipeline::worker_loop, this);
+    }
+
+    void stop() {
+        if (!m_is_running) {
+            return;
+        }
+        m_is_running = false;
+        m_credits.stop();
+        m_ready.stop();
+        if (m_worker_thread.joinable()) {
+            m_worker_thread.join();
+        }
+    }
+
+    // 非阻塞取数据，尚未生产好时返回false
+    bool try_take(T& value) {
+        if (!m_ready.try_pop(value)) {
+            return false;
+        }
+        m_credits.push(1);
+        return true;
+    }
+
+    // 阻塞取数据，流水线停止时返回false
+    bool take(T& value) {
+        if (!m_ready.pop(value)) {
+            return false;
+        }
+        m_credits.push(1);
+        return true;
+    }
+
+    // 队列后端支持原地读写（如 SpscRingBuffer）时，数据直接在队列槽位中生产与读取
+    static constexpr bool IN_PLACE = requires(Queue<T>& queue) {
+        { queue.claim() } -> std::same_as<T*>;
+        queue.commit();
+        { queue.try_front() } -> std::same_as<T*>;
+        { queue.front() } -> std::same_as<T*>;
+        queue.release();
+    };
+
+    // 非阻塞地原地访问下一个数据，尚未生产好时返回 nullptr；用完后必须调用 release
+    T* try_acquire() requires IN_PLACE {
+        return m_ready.try_front();
+    }
+
+    // 阻塞地原地访问下一个数据，流水线停止时返回 nullptr；用完后必须调用 release
+    T* acquire() requires IN_PLACE {
+        return m_ready.front();
+    }
+
+    // 归还 acquire 得到的数据槽，并为工作线程补充一个额度
+    void release() requires IN_PLACE {
+        m_ready.release();
+        m_credits.push(1);
+    }
+
+private:
+    void worker_loop() {
+        int credit = 0;
+        while (m_credits.pop(credit)) {
+            if constexpr (IN_PLACE) {
+                T* slot = m_ready.claim();
+                if (slot == nullptr) {
+                    break;
+                }
+                m_producer_task(*slot);
+                m_ready.commit();
+            } else {
+                T item;
+                m_producer_task(item);
+                m_ready.push(std::move(item));
+            }
+        }
+    }
+
+    Queue<T> m_ready;
+    Queue<int> m_credits;
+    std::thread m_worker_thread;
+    std::function<void(T&)> m_producer_task;
+    std::atomic<bool> m_is_running{false};
+};
+
 #endif //PRODUCERCONSUMER_H
\ No newline at end of file
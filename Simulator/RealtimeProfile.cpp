@@ -0,0 +1,105 @@
+#include "RealtimeProfile.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr size_t PAGE_SIZE_FALLBACK = 4096;
+
+size_t page_size() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    const long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : PAGE_SIZE_FALLBACK;
+#endif
+}
+
+#ifndef _WIN32
+const char* privilege_hint(int error) {
+    return (error == EPERM || error == ENOMEM) ? "（权限或资源限制不足，请检查 CAP_SYS_NICE/CAP_IPC_LOCK 与 ulimit）" : "";
+}
+#endif
+} // namespace
+
+bool Realtime::applyToCurrentThread(const RealtimeProfile& profile) {
+    bool ok = true;
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        std::cerr << "警告：无法提升仿真线程优先级" << std::endl;
+        ok = false;
+    }
+    if (profile.cpu_core >= 0 &&
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << profile.cpu_core) == 0) {
+        std::cerr << "警告：无法将仿真线程绑定到CPU " << profile.cpu_core << std::endl;
+        ok = false;
+    }
+#else
+    if (profile.lock_memory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        const int error = errno;
+        std::cerr << "警告：mlockall 失败: " << std::strerror(error) << privilege_hint(error) << std::endl;
+        ok = false;
+    }
+
+    if (profile.cpu_core >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(profile.cpu_core, &cpus);
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) {
+            std::cerr << "警告：无法将仿真线程绑定到CPU " << profile.cpu_core << ": " << std::strerror(error) << std::endl;
+            ok = false;
+        }
+    }
+
+    sched_param param{};
+    param.sched_priority = profile.fifo_priority;
+    const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+        std::cerr << "警告：无法设置 SCHED_FIFO 优先级 " << profile.fifo_priority << ": "
+                  << std::strerror(error) << privilege_hint(error) << std::endl;
+        ok = false;
+    }
+#endif
+    return ok;
+}
+
+void Realtime::prefault(const void* data, size_t size) {
+    if (data == nullptr || size == 0) {
+        return;
+    }
+    const size_t step = page_size();
+    const volatile unsigned char* bytes = static_cast<const volatile unsigned char*>(data);
+    unsigned char sink = 0;
+    for (size_t offset = 0; offset < size; offset += step) {
+        sink ^= bytes[offset];
+    }
+    sink ^= bytes[size - 1];
+    (void)sink;
+}
+
+void Realtime::prefaultStack(size_t bytes) {
+    constexpr size_t CHUNK = 16 * 1024;
+    volatile unsigned char buffer[CHUNK];
+    if (bytes > CHUNK) {
+        prefaultStack(bytes - CHUNK); // 分段递归，避免单个过大的栈帧；buffer 在调用后仍被使用，不会被尾调用优化
+    }
+    const size_t step = page_size();
+    unsigned char sink = 0;
+    for (size_t offset = 0; offset < CHUNK; offset += step) {
+        buffer[offset] = 0;
+        sink ^= buffer[offset];
+    }
+    (void)sink;
+}
@@ -0,0 +1,40 @@
+//
+// Created by fyh on 25-8-18.
+//
+
+#ifndef REALTIMEPROFILE_H
+#define REALTIMEPROFILE_H
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief 仿真周期线程的实时执行配置（默认关闭）。
+ *
+ * Linux 下依次尝试：SCHED_FIFO 调度、绑定CPU核心、mlockall 锁定内存、预先触碰栈页。
+ * 缺少权限（CAP_SYS_NICE / CAP_IPC_LOCK 或 RLIMIT_RTPRIO / RLIMIT_MEMLOCK 不足）时只输出警告，
+ * 仿真继续以普通线程运行。Windows 下仅提升线程优先级并设置亲和性。
+ */
+struct RealtimeProfile {
+    bool enabled = false;
+    int fifo_priority = 80;            // SCHED_FIFO 优先级 (1-99)
+    int cpu_core = -1;                 // 绑定的CPU核心，-1 表示不绑定
+    bool lock_memory = true;           // mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t prefault_stack_bytes = 256 * 1024; // 预先触碰的栈空间
+};
+
+namespace Realtime {
+    /**
+     * @brief 将调度策略、亲和性与内存锁定应用到调用线程。
+     * @return 所有请求的设置均成功时返回 true，失败项已输出警告
+     */
+    bool applyToCurrentThread(const RealtimeProfile& profile);
+
+    // 逐页触碰一段内存，使其在首个周期前完成缺页
+    void prefault(const void* data, size_t size);
+
+    // 在当前线程栈上触碰 bytes 字节，避免周期内首次使用深层栈时缺页
+    void prefaultStack(size_t bytes);
+}
+
+#endif //REALTIMEPROFILE_H
@@ -0,0 +1,422 @@
+#include "ScenarioBatch.h"
+#include "ConsistTrajectory.h"
+#include "EnergyOptimizer.h"
+#include "WorkStealingPool.h"
+#include "TrainCommunicator/FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+std::string trim(const std::string& text) {
+    const size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    const size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+// 整行恰好是一个数值时返回 true
+template<typename T>
+bool parse_value(const std::string& text, T& value) {
+    std::istringstream iss(text);
+    return (iss >> value) && (iss >> std::ws).eof();
+}
+
+bool parse_event(const std::string& line, ScenarioEvent& event, std::string& reason) {
+    std::istringstream iss(line);
+    std::string at, command, value;
+    if (!(iss >> at >> event.time_s >> command >> value) || !(iss >> std::ws).eof() || event.time_s < 0.0) {
+        reason = "控制指令格式应为 at <时间 s> mode|level|jerk_gear <值>";
+        return false;
+    }
+    command = lower(command);
+    value = lower(value);
+    if (command == "mode") {
+        static const std::map<std::string, TrainController::ControlMode> modes{
+            {"automatic", TrainController::ControlMode::AUTOMATIC},
+            {"manual", TrainController::ControlMode::MANUAL}};
+        const auto it = modes.find(value);
+        if (it == modes.end()) {
+            reason = "未知的控制模式: " + value;
+            return false;
+        }
+        event.type = ScenarioEvent::Type::MODE;
+        event.value = static_cast<int>(it->second);
+    } else if (command == "level") {
+        static const std::map<std::string, TrainController::ControlLevel> levels{
+            {"idle", TrainController::ControlLevel::IDLE},
+            {"cruise", TrainController::ControlLevel::CRUISE},
+            {"traction_1", TrainController::ControlLevel::TRACTION_1},
+            {"traction_2", TrainController::ControlLevel::TRACTION_2},
+            {"traction_3", TrainController::ControlLevel::TRACTION_3},
+            {"brake_1", TrainController::ControlLevel::BRAKE_1},
+            {"brake_2", TrainController::ControlLevel::BRAKE_2},
+            {"brake_3", TrainController::ControlLevel::BRAKE_3}};
+        const auto it = levels.find(value);
+        if (it == levels.end()) {
+            reason = "未知的手动档位: " + value;
+            return false;
+        }
+        event.type = ScenarioEvent::Type::LEVEL;
+        event.value = static_cast<int>(it->second);
+    } else if (command == "jerk_gear") {
+        if (!parse_value(value, event.value) || event.value < 0 || event.value > 2) {
+            reason = "jerk_gear 取值应为 0/1/2";
+            return false;
+        }
+        event.type = ScenarioEvent::Type::JERK_GEAR;
+    } else {
+        reason = "未知的控制指令: " + command;
+        return false;
+    }
+    return true;
+}
+
+void apply_event(TrainController& controller, const ScenarioEvent& event) {
+    switch (event.type) {
+        case ScenarioEvent::Type::MODE:
+            controller.setControlMode(static_cast<TrainController::ControlMode>(event.value));
+            break;
+        case ScenarioEvent::Type::LEVEL:
+            controller.setControlLevel(static_cast<TrainController::ControlLevel>(event.value));
+            break;
+        case ScenarioEvent::Type::JERK_GEAR:
+            controller.setJerkGear(event.value);
+            break;
+    }
+}
+
+long long ms_to_ns(double ms) {
+    return static_cast<long long>(std::llround(ms * 1e6));
+}
+
+// 按 RFC 4180 输出字符串字段：含逗号、引号或换行时整体加引号，内部引号成对转义
+std::string csv_field(const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (const char c : text) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+} // namespace
+
+bool Scenario::load(const std::string& path, Scenario& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "无法打开场景文件";
+        return false;
+    }
+
+    Scenario scenario;
+    scenario.source_file = path;
+    scenario.name = std::filesystem::path(path).stem().string();
+    int users = 1;
+    int cars = 0;
+    int trajectory_id = 1;
+    int trajectory_type = 1;
+
+    std::string line;
+    size_t line_number = 0;
+    auto fail = [&](const std::string& reason) {
+        error = "第 " + std::to_string(line_number) + " 行：" + reason;
+        return false;
+    };
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        if (lower(line.substr(0, 3)) == "at " || lower(line.substr(0, 3)) == "at\t") {
+            ScenarioEvent event;
+            std::string reason;
+            if (!parse_event(line, event, reason)) {
+                return fail(reason);
+            }
+            scenario.script.push_back(event);
+            continue;
+        }
+
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            return fail("应为 key = value");
+        }
+        const std::string key = lower(trim(line.substr(0, eq)));
+        const std::string value = trim(line.substr(eq + 1));
+        bool valid = true;
+        if (key == "name") {
+            scenario.name = value;
+            valid = !value.empty();
+        } else if (key == "route") {
+            std::filesystem::path route_path(value);
+            if (route_path.is_relative()) {
+                route_path = std::filesystem::path(path).parent_path() / route_path;
+            }
+            scenario.route_file = route_path.lexically_normal().string();
+            valid = !value.empty();
+        } else if (key == "duration") {
+            valid = parse_value(value, scenario.duration_s) && scenario.duration_s > 0.0;
+        } else if (key == "interval_ms") {
+            valid = parse_value(value, scenario.interval_ms) && scenario.interval_ms > 0;
+        } else if (key == "max_speed") {
+            valid = parse_value(value, scenario.vehicle.maxSpeed) && scenario.vehicle.maxSpeed > 0.0;
+        } else if (key == "train_length") {
+            valid = parse_value(value, scenario.vehicle.trainLong) && scenario.vehicle.trainLong > 0.0;
+        } else if (key == "resistance") {
+            std::istringstream iss(value);
+            double* c = scenario.vehicle.resistanceCoefficients;
+            valid = (iss >> c[0] >> c[1] >> c[2]) && (iss >> std::ws).eof();
+        } else if (key == "traction") {
+            valid = parse_value(value, scenario.vehicle.tractionAcceleration) && scenario.vehicle.tractionAcceleration > 0.0;
+        } else if (key == "braking") {
+            valid = parse_value(value, scenario.vehicle.brakingAcceleration) && scenario.vehicle.brakingAcceleration < 0.0;
+        } else if (key == "users") {
+            valid = parse_value(value, users) && (users == 1 || users == 2);
+        } else if (key == "cars") {
+            valid = parse_value(value, cars) && cars > 0 && cars <= static_cast<int>(MAX_CONSIST_USERS);
+        } else if (key == "trajectory_id") {
+            valid = parse_value(value, trajectory_id);
+        } else if (key == "trajectory_type") {
+            valid = parse_value(value, trajectory_type);
+        } else if (key == "jerk_gear") {
+            valid = parse_value(value, scenario.jerk_gear) && scenario.jerk_gear >= 0 && scenario.jerk_gear <= 2;
+        } else if (key == "trip_time") {
+            valid = parse_value(value, scenario.trip_time) && scenario.trip_time >= 0.0;
+        } else if (key == "stop_at_station") {
+            int flag = 0;
+            valid = parse_value(value, flag);
+            scenario.stop_at_station = flag != 0;
+        } else {
+            return fail("未知的配置项: " + key);
+        }
+        if (!valid) {
+            return fail("取值无效: " + key + " = " + value);
+        }
+    }
+
+    if (scenario.route_file.empty()) {
+        error = "缺少 route";
+        return false;
+    }
+    if (cars > 0) {
+        scenario.consist = make_per_car_consist(cars, scenario.vehicle.trainLong, trajectory_id, trajectory_type);
+    } else {
+        scenario.consist.push_back({trajectory_id, trajectory_type, 0.0});
+        if (users == 2) {
+            scenario.consist.push_back({trajectory_id + 1, trajectory_type, scenario.vehicle.trainLong});
+        }
+    }
+    std::stable_sort(scenario.script.begin(), scenario.script.end(),
+                     [](const ScenarioEvent& lhs, const ScenarioEvent& rhs) { return lhs.time_s < rhs.time_s; });
+    out = std::move(scenario);
+    return true;
+}
+
+ScenarioBatch::ScenarioBatch(ScenarioBatchOptions options)
+    : options_(std::move(options)) {}
+
+std::vector<ScenarioResult> ScenarioBatch::run(const std::vector<Scenario>& scenarios, size_t thread_count) const {
+    std::vector<ScenarioResult> results(scenarios.size());
+    WorkStealingPool pool(thread_count);
+
+    // 每条线路只加载一次，加载本身也并行进行
+    std::map<std::string, size_t> route_index;
+    std::vector<std::string> route_files;
+    for (const Scenario& scenario : scenarios) {
+        if (route_index.emplace(scenario.route_file, route_files.size()).second) {
+            route_files.push_back(scenario.route_file);
+        }
+    }
+    std::vector<std::unique_ptr<Route>> routes(route_files.size());
+    pool.parallel_for(0, route_files.size(), [&](size_t i) {
+        auto route = std::make_unique<Route>();
+        if (route->loadFromFile(route_files[i])) {
+            routes[i] = std::move(route);
+        }
+    });
+
+    // 输出文件名取场景名，重名时追加序号
+    std::vector<std::string> output_files(scenarios.size());
+    if (options_.write_trajectories) {
+        std::filesystem::create_directories(options_.output_dir);
+        std::set<std::string> used;
+        for (size_t i = 0; i < scenarios.size(); ++i) {
+            std::string stem = scenarios[i].name;
+            for (size_t n = 2; !used.insert(stem).second; ++n) {
+                stem = scenarios[i].name + "_" + std::to_string(n);
+            }
+            output_files[i] = (std::filesystem::path(options_.output_dir) / (stem + ".cap")).string();
+        }
+    }
+
+    // 按周期数 × 用户数从大到小提交，最长的场景最先开始，减少批次末尾的长尾
+    std::vector<size_t> order(scenarios.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    auto cost = [&scenarios](size_t i) {
+        return scenarios[i].duration_s / scenarios[i].interval_ms * static_cast<double>(std::max<size_t>(1, scenarios[i].consist.size()));
+    };
+    std::stable_sort(order.begin(), order.end(), [&cost](size_t lhs, size_t rhs) { return cost(lhs) > cost(rhs); });
+
+    for (const size_t i : order) {
+        pool.submit([this, &scenarios, &results, &routes, &route_index, &output_files, i] {
+            const Route* route = routes[route_index.at(scenarios[i].route_file)].get();
+            if (route == nullptr) {
+                results[i].name = scenarios[i].name;
+                results[i].source_file = scenarios[i].source_file;
+                results[i].error = "加载路线文件失败: " + scenarios[i].route_file;
+                return;
+            }
+            try {
+                results[i] = runSingle(scenarios[i], *route, output_files[i]);
+            } catch (const std::exception& e) {
+                results[i] = ScenarioResult{};
+                results[i].name = scenarios[i].name;
+                results[i].source_file = scenarios[i].source_file;
+                results[i].error = e.what();
+            }
+        });
+    }
+    pool.wait_idle();
+    return results;
+}
+
+ScenarioResult ScenarioBatch::runSingle(const Scenario& scenario, const Route& route, const std::string& output_file) const {
+    const auto wall_begin = std::chrono::steady_clock::now();
+    ScenarioResult result;
+    result.name = scenario.name;
+    result.source_file = scenario.source_file;
+
+    std::vector<ConsistUser> users = scenario.consist;
+    if (users.empty()) {
+        users.push_back(ConsistUser{});
+    }
+    ConsistTrajectory consist(route, std::move(users), scenario.vehicle.trainLong);
+    result.users = consist.user_count();
+
+    TrainController controller(scenario.vehicle, route.getTotalDistance(), &route.getTrackProfile(), false);
+    controller.setJerkGear(scenario.jerk_gear);
+    if (scenario.trip_time > 0.0) {
+        const EnergyOptimizationResult plan = EnergyOptimizer(route, scenario.vehicle).optimize(scenario.trip_time);
+        controller.setDrivingProfile(std::make_shared<DrivingProfile>(plan.profile));
+    }
+
+    // 捕获文件与实时发送的帧流一致：START、每周期一帧轨迹、STOP；时间戳为仿真时刻
+    std::unique_ptr<FrameCaptureWriter> writer;
+    TrajectoryFrame frame{};
+    if (!output_file.empty()) {
+        // 离线运行不受实时约束，缓冲满时等待写盘而不是丢帧
+        writer = std::make_unique<FrameCaptureWriter>(output_file, CaptureOverflow::BLOCK);
+        result.output_file = output_file;
+
+        StartCommand start{};
+        start.command_word = start_command_word(consist.user_count());
+        start.simulation_duration = static_cast<uint64_t>(std::llround(scenario.duration_s * 1000.0));
+        start.data_length = static_cast<uint32_t>(start_command_size(consist.user_count()));
+        std::vector<StartUserParams> start_users(consist.user_count());
+        consist.initial_users(start_users.data());
+        const size_t start_size = serialize_start_command(start, start_users.data(), start_users.size(), frame.payload_bytes());
+        const size_t frame_size = frame.set_payload_length(static_cast<uint32_t>(start_size));
+        const void* part = &frame;
+        writer->append(0, &part, &frame_size, 1);
+    }
+
+    const double dt = static_cast<double>(scenario.interval_ms) / 1000.0;
+    const auto max_ticks = static_cast<unsigned long long>(std::llround(scenario.duration_s * 1000.0 / scenario.interval_ms));
+    size_t next_event = 0;
+    bool departed = false;
+
+    for (unsigned long long tick = 1; tick <= max_ticks; ++tick) {
+        // 与实时仿真一致：第 tick 周期的轨迹时间为 (tick-1)*dt，指令在周期开始、推进动力学之前生效
+        const double trajectory_time = static_cast<double>(tick - 1) * dt;
+        while (next_event < scenario.script.size() && scenario.script[next_event].time_s <= trajectory_time + 1e-9) {
+            apply_event(controller, scenario.script[next_event++]);
+        }
+        controller.update(dt);
+        const KinematicState& state = controller.getCurrentState();
+        result.ticks = tick;
+        result.max_speed = std::max(result.max_speed, state.velocity * 3.6);
+        result.max_jerk = std::max(result.max_jerk, std::abs(state.jerk));
+
+        if (writer) {
+            const size_t payload_size = consist.write(state, trajectory_time, tick, frame.payload_bytes());
+            const size_t frame_size = frame.set_payload_length(static_cast<uint32_t>(payload_size));
+            const void* part = &frame;
+            writer->append(ms_to_ns(static_cast<double>(tick) * scenario.interval_ms), &part, &frame_size, 1);
+        }
+
+        const TrainState train_state = controller.getTrainState();
+        if (train_state != TrainState::STOPPED) {
+            departed = true;
+        } else if (departed && !result.arrived) {
+            // 自动停车：控制器已将位置对齐到车站，误差取对齐前的位置
+            result.arrived = true;
+            result.stop_error = controller.getStopPosition() - controller.getStationPosition();
+            if (scenario.stop_at_station && next_event == scenario.script.size()) {
+                break;
+            }
+        }
+    }
+    result.simulated_time = static_cast<double>(result.ticks) * dt;
+    result.final_position = controller.getCurrentState().position;
+
+    if (writer) {
+        StopCommand stop{};
+        stop.command_word = COMMAND_STOP;
+        stop.data_length = static_cast<uint32_t>(StopCommandLayout::size);
+        StopCommandLayout::write(stop, frame.payload_bytes());
+        const size_t frame_size = frame.set_payload_length(static_cast<uint32_t>(StopCommandLayout::size));
+        const void* part = &frame;
+        writer->append(ms_to_ns(static_cast<double>(result.ticks + 1) * scenario.interval_ms), &part, &frame_size, 1);
+        writer->close();
+        if (writer->failed()) {
+            result.error = "写入轨迹文件失败: " + output_file;
+            return result;
+        }
+    }
+    result.ok = true;
+    result.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_begin).count();
+    return result;
+}
+
+void ScenarioBatch::writeCsv(std::ostream& out, const std::vector<ScenarioResult>& results) {
+    out << "scenario,source,status,users,ticks,simulated_s,final_position_m,max_speed_kmh,max_jerk,arrived,stop_error_m,wall_ms,output,error\n";
+    for (const auto& r : results) {
+        out << csv_field(r.name) << ','
+            << csv_field(r.source_file) << ','
+            << (r.ok ? "ok" : "failed") << ','
+            << r.users << ','
+            << r.ticks << ','
+            << r.simulated_time << ','
+            << r.final_position << ','
+            << r.max_speed << ','
+            << r.max_jerk << ','
+            << (r.arrived ? 1 : 0) << ','
+            << r.stop_error << ','
+            << r.wall_ms << ','
+            << csv_field(r.output_file) << ','
+            << csv_field(r.error) << '\n';
+    }
+}
@@ -0,0 +1,121 @@
+//
+// Created by fyh on 25-8-23.
+//
+
+#ifndef SCENARIOBATCH_H
+#define SCENARIOBATCH_H
+#pragma once
+
+#include "SimulatorConfiguration.h"
+#include "DynamicModel/TestVehicle.h"
+#include "DynamicModel/TrainController.h"
+#include "TrajKit/Route.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 控制脚本中的一条指令，在仿真时间到达 time_s 的周期开始时执行
+struct ScenarioEvent {
+    enum class Type {
+        MODE,      // value 为 TrainController::ControlMode
+        LEVEL,     // value 为 TrainController::ControlLevel
+        JERK_GEAR  // value 为 0/1/2
+    };
+
+    double time_s = 0.0;
+    Type type = Type::MODE;
+    int value = 0;
+};
+
+/**
+ * @brief 一个离线场景：车辆、线路、时长与控制脚本。
+ *
+ * 场景文件为 UTF-8 文本，每行一项，# 之后为注释：
+ *
+ *   name = demo                       # 缺省取文件名
+ *   route = ../trajectory_BLH.txt     # 相对路径以场景文件所在目录为基准
+ *   duration = 600                    # 仿真时长 (s)
+ *   interval_ms = 20
+ *   max_speed = 120                   # km/h
+ *   train_length = 200                # m
+ *   resistance = 2.28 0.0293 0.000178
+ *   traction = 0.6                    # m/s^2
+ *   braking = -0.9                    # m/s^2
+ *   users = 2                         # 1: 车头；2: 车头+车尾
+ *   cars = 8                          # 取代 users：每节车中心一个用户
+ *   trajectory_id = 1                 # 首个用户的轨迹号，其余顺延
+ *   jerk_gear = 2
+ *   trip_time = 0                     # 大于 0 时按节能驾驶剖面运行
+ *   stop_at_station = 1               # 自动停车后提前结束
+ *   at 30 mode manual                 # 控制脚本：at <时间 s> mode|level|jerk_gear <值>
+ *   at 30 level traction_2
+ */
+struct Scenario {
+    std::string name;
+    std::string source_file;
+    std::string route_file;
+    TrainInfo vehicle{L"ScenarioTrain", 120.0, 200.0, {2.28, 0.0293, 0.000178}, 0.6, -0.9};
+    std::vector<ConsistUser> consist;       // 为空时只有车头一个用户
+    int interval_ms = 20;
+    double duration_s = 600.0;
+    int jerk_gear = 2;
+    double trip_time = 0.0;
+    bool stop_at_station = true;
+    std::vector<ScenarioEvent> script;      // 按时间升序
+
+    // 解析场景文件；失败时返回 false 并在 error 中给出行号与原因
+    static bool load(const std::string& path, Scenario& out, std::string& error);
+};
+
+// 单个场景的运行结果
+struct ScenarioResult {
+    std::string name;
+    std::string source_file;
+    std::string output_file;  // 未写出轨迹时为空
+    bool ok = false;
+    std::string error;
+
+    size_t users = 0;
+    unsigned long long ticks = 0;
+    double simulated_time = 0.0;  // s
+    double final_position = 0.0;  // m
+    double max_speed = 0.0;       // km/h
+    double max_jerk = 0.0;        // m/s^3
+    bool arrived = false;         // 是否已在车站停车
+    double stop_error = 0.0;      // 停车位置 - 车站位置 (m)
+    double wall_ms = 0.0;
+};
+
+struct ScenarioBatchOptions {
+    std::string output_dir = ".";
+    bool write_trajectories = true; // 每个场景写一个捕获文件（含 START/STOP），可直接由 TrainReplay 回放
+};
+
+/**
+ * @brief 在工作窃取线程池上并行运行一批离线场景。
+ *
+ * 每个场景构造独立的 TrainController，以固定步长离线推进（不受墙钟限制、不写逐周期日志、
+ * 不发送 UDP）；同一路线文件只加载一次并由各场景只读共享。轨迹帧与实时仿真使用同一套
+ * 编组换算和线上布局，时间戳为仿真时刻，回放时即按原周期节拍发送。
+ */
+class ScenarioBatch {
+public:
+    explicit ScenarioBatch(ScenarioBatchOptions options);
+
+    /**
+     * @brief 运行全部场景。
+     * @param thread_count 线程数，0 表示使用全部核心
+     * @return 与 scenarios 顺序一致的运行结果
+     */
+    std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios, size_t thread_count = 0) const;
+
+    // 每个结果一行；场景名、路径与错误信息按 RFC 4180 加引号转义
+    static void writeCsv(std::ostream& out, const std::vector<ScenarioResult>& results);
+
+private:
+    ScenarioResult runSingle(const Scenario& scenario, const Route& route, const std::string& output_file) const;
+
+    ScenarioBatchOptions options_;
+};
+
+#endif //SCENARIOBATCH_H
@@ -8,11 +8,41 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <locale>
 #include "DynamicModel/TestVehicle.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+#include "TrainCommunicator/SimClock.h"
+#include "TrainCommunicator/UdpCommunicator.h"
+#include "RealtimeProfile.h"
+#include "TrajectoryTable.h"
+
+// 额外的UDP目的地（单播或组播地址）
+struct UdpDestination {
+    std::wstring ip;
+    int port = 0;
+};
+
+// 编组中的一个用户（天线），位于车头之后 offset_m 米处
+struct ConsistUser {
+    int trajectory_id = 1;
+    int trajectory_type = 1;
+    double offset_m = 0.0; // 0 为车头，trainLong 为车尾
+};
+
+// 每节车中心一个用户，轨迹号从 first_trajectory_id 起连续编号
+inline std::vector<ConsistUser> make_per_car_consist(int car_count, double train_length,
+                                                     int first_trajectory_id = 1, int trajectory_type = 1) {
+    std::vector<ConsistUser> users;
+    const double car_length = car_count > 0 ? train_length / car_count : 0.0;
+    for (int i = 0; i < car_count; ++i) {
+        users.push_back({first_trajectory_id + i, trajectory_type, (i + 0.5) * car_length});
+    }
+    return users;
+}
 
 struct SimulatorConfiguration {
     TrainInfo test_vehicle;
@@ -20,6 +50,39 @@ struct SimulatorConfiguration {
     std::wstring ip;
     int port;
     int SIMULATION_INTERVAL_MS;
+    // 同一轨迹数据流额外发往的目的地（如多台信号模拟器、记录仪），Linux 下一次 sendmmsg 扇出
+    std::vector<UdpDestination> extra_destinations;
+    int multicast_ttl = 1;
+    // UDP 发送后端；io_uring 不可用时自动回退到 sendmsg
+    SendBackend send_backend = SendBackend::SENDMSG;
+    // 定时器超期处理策略；CATCH_UP 与 SKIP 都能保证 trajectory_time 与墙钟一致
+    TimerOverrunPolicy timer_overrun_policy = TimerOverrunPolicy::CATCH_UP;
+    // 仿真时钟：SCALED 时按 clock_scale 倍速运行（UDP 发送频率同比例提高），MANUAL 时由 advance_clock 步进
+    ClockMode clock_mode = ClockMode::REAL;
+    double clock_scale = 1.0;
+    // 多实例部署时由进程内共享的 TickScheduler 驱动，不再为每个实例创建定时器线程
+    bool use_shared_scheduler = false;
+    // 首个周期的相位偏移 (us)，共享调度时用于错开各实例的触发时刻
+    int timer_phase_us = 0;
+    // 仿真周期线程的实时执行配置（SCHED_FIFO、CPU亲和性、mlockall、预缺页）；共享调度时只做预缺页
+    RealtimeProfile realtime;
+    // 预计算流水线深度：0 表示在定时器回调内完成计算与发送；N>0 时由工作线程提前 N 个周期
+    // 计算数据包，定时器线程只负责按时发送（控制指令相应延后 N 个周期生效）
+    int pipeline_depth = 0;
+    // 接收模拟器回执（AckMessage）：独立线程监听发送 socket，匹配 START/STOP 应答并统计数据流往返时延
+    bool enable_feedback = false;
+    // 大于 0 时 start_simulation 最多等待该时长的 START 应答；应答为拒绝时启动失败，超时只告警
+    int ack_timeout_ms = 0;
+    // 非空时把发出的每一帧（含帧头）连同时间戳写入该捕获文件，供 TrainReplay 回放
+    std::wstring capture_file;
+    // 轨迹来源：PRECOMPUTED 时在定时器启动前按自动驾驶生成 simulation_duration 内的全部帧，周期内只读取
+    // 下一条记录并写入序号；运行中的控制指令不再生效，pipeline_depth 被忽略
+    TrajectorySource trajectory_source = TrajectorySource::LIVE;
+    // 轨迹表映射到的文件，为空时使用匿名内存映射
+    std::wstring trajectory_table_file;
+    // 0 表示启动前生成整表；N>0 时启动前只生成前 N 个周期，其余由后台线程在播放的同时继续生成；
+    // 生成落后时播放最多等待半个周期，之后重发最近一条已生成的记录
+    int precompute_chunk_ticks = 0;
 
     // 指令相关
     long long simulation_start_time = 0;
@@ -29,6 +92,11 @@ struct SimulatorConfiguration {
     int trajectory_ID_user2 = 2;
     int trajectory_type_user2 = 1;
     bool enable_second_user = false; // 0: 单用户；1: 双用户
+    // 非空时取代上面的单/双用户设置：每个用户一路轨迹，至多 MAX_CONSIST_USERS 个，帧内按此顺序排列
+    std::vector<ConsistUser> consist_users;
+
+    // 节能驾驶：大于 0 时按该目标运行时分 (s) 优化自动模式的驾驶剖面
+    double energy_optimal_trip_time = 0.0;
 };
 
 /**
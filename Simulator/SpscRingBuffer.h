@@ -0,0 +1,293 @@
+//
+// Created by fyh on 25-8-19.
+//
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+// 队列空/满时的等待方式
+enum class WaitStrategy {
+    SPIN,  // 忙等，延迟最低，独占一个核心
+    YIELD, // 忙等并让出时间片
+    FUTEX  // 先短暂让出时间片，仍未就绪再基于 std::atomic::wait 休眠（Linux 下为 futex），
+           // 只在对端确实在等待时才唤醒
+};
+
+/**
+ * @brief 有界无锁单生产者/单消费者环形缓冲。
+ *
+ * 槽位在构造时一次性分配，push/pop 不再分配内存；读写索引与各自的缓存副本分别独占缓存行，
+ * 避免生产者与消费者之间的伪共享。接口与 ThreadSafeQueue 保持一致，可作为 ProducerConsumer
+ * 与 LookaheadPipeline 的队列后端；push 在队列满时按 Wait 策略等待（背压）。
+ * claim/commit 与 front/release 允许两端直接在槽位内构造和读取元素，适合较大的定长数据。
+ * @tparam T 元素类型，需可默认构造与移动赋值
+ * @tparam Capacity 容量，必须为 2 的幂
+ * @tparam Wait 空/满时的等待策略
+ */
+template<typename T, size_t Capacity, WaitStrategy Wait = WaitStrategy::FUTEX>
+class SpscRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    SpscRingBuffer() = default;
+    ~SpscRingBuffer() {
+        stop();
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    // ---- 生产者端 ----
+
+    // 队列满时立即返回false，value 保持不变
+    template<typename U>
+    bool try_push(U&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) {
+                return false;
+            }
+        }
+        slots_[tail & MASK] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        wake(consumer_waiting_, consumer_epoch_);
+        return true;
+    }
+
+    // 队列满时等待消费者腾出空间；队列已停止时丢弃元素
+    void push(T value) {
+        unsigned attempts = 0;
+        while (!try_push(std::move(value))) {
+            if (stopped_.load(std::memory_order_acquire)) {
+                return;
+            }
+            wait(attempts, producer_waiting_, producer_epoch_, [this] {
+                return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) < Capacity;
+            });
+        }
+    }
+
+    // ---- 消费者端 ----
+
+    bool try_pop(T& value) {
+        return try_pop_batch(&value, 1) == 1;
+    }
+
+    // 一次取出最多 max_count 个元素，返回实际数量
+    size_t try_pop_batch(T* out, size_t max_count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (cached_tail_ == head) {
+                return 0;
+            }
+        }
+        const size_t available = cached_tail_ - head;
+        const size_t count = available < max_count ? available : max_count;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::move(slots_[(head + i) & MASK]);
+        }
+        head_.store(head + count, std::memory_order_release);
+        wake(producer_waiting_, producer_epoch_);
+        return count;
+    }
+
+    // 阻塞直到取到元素；队列已停止且为空时返回false
+    bool pop(T& value) {
+        return pop_batch(&value, 1) == 1;
+    }
+
+    // 阻塞直到至少取到一个元素；队列已停止且为空时返回0
+    size_t pop_batch(T* out, size_t max_count) {
+        unsigned attempts = 0;
+        while (true) {
+            const size_t count = try_pop_batch(out, max_count);
+            if (count > 0) {
+                return count;
+            }
+            if (stopped_.load(std::memory_order_acquire)) {
+                return try_pop_batch(out, max_count);
+            }
+            wait(attempts, consumer_waiting_, consumer_epoch_, [this] {
+                return tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    // ---- 原地读写：直接在槽位中构造/读取元素，不经过额外拷贝 ----
+
+    // 生产者：返回下一个空槽供原地填充，队列满时返回 nullptr；填充完成后调用 commit
+    T* try_claim() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) {
+                return nullptr;
+            }
+        }
+        return &slots_[tail & MASK];
+    }
+
+    // 阻塞直到有空槽；队列已停止时返回 nullptr
+    T* claim() {
+        unsigned attempts = 0;
+        while (true) {
+            if (T* slot = try_claim()) {
+                return slot;
+            }
+            if (stopped_.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            wait(attempts, producer_waiting_, producer_epoch_, [this] {
+                return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) < Capacity;
+            });
+        }
+    }
+
+    // 发布 claim 得到的槽位
+    void commit() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        wake(consumer_waiting_, consumer_epoch_);
+    }
+
+    // 消费者：返回最早的元素供原地读取，队列空时返回 nullptr；用完后调用 release
+    T* try_front() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (cached_tail_ == head) {
+                return nullptr;
+            }
+        }
+        return &slots_[head & MASK];
+    }
+
+    // 阻塞直到有元素；队列已停止且为空时返回 nullptr
+    T* front() {
+        unsigned attempts = 0;
+        while (true) {
+            if (T* slot = try_front()) {
+                return slot;
+            }
+            if (stopped_.load(std::memory_order_acquire)) {
+                return try_front();
+            }
+            wait(attempts, consumer_waiting_, consumer_epoch_, [this] {
+                return tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    // 归还 front 得到的槽位
+    void release() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        wake(producer_waiting_, producer_epoch_);
+    }
+
+    // ---- 控制 ----
+
+    // 停止队列，唤醒两端所有等待者
+    void stop() {
+        stopped_.store(true, std::memory_order_seq_cst);
+        consumer_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        producer_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if constexpr (Wait == WaitStrategy::FUTEX) {
+            consumer_epoch_.notify_all();
+            producer_epoch_.notify_all();
+        }
+    }
+
+    // 清空并重新启用，仅在两端都未运行时调用
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cached_head_ = 0;
+        cached_tail_ = 0;
+        stopped_.store(false, std::memory_order_release);
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    static void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    // FUTEX 策略进入休眠前的让出次数，使对端在连续生产/消费时不必每个元素都经历一次唤醒
+    static constexpr unsigned YIELDS_BEFORE_SLEEP = 64;
+
+    // 在条件满足、队列停止或被对端唤醒前等待一次；attempts 为本次等待已重试的次数
+    template<typename Ready>
+    void wait(unsigned& attempts, std::atomic<bool>& waiting, std::atomic<uint32_t>& epoch, Ready ready) {
+        if constexpr (Wait == WaitStrategy::SPIN) {
+            cpu_relax();
+        } else if constexpr (Wait == WaitStrategy::YIELD) {
+            std::this_thread::yield();
+        } else if (attempts++ < YIELDS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+        } else {
+            // 先登记等待再复查条件，与 wake 中的 seq_cst 栅栏配对，避免丢失唤醒
+            const uint32_t observed = epoch.load(std::memory_order_acquire);
+            waiting.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready() && !stopped_.load(std::memory_order_seq_cst)) {
+                epoch.wait(observed, std::memory_order_acquire);
+            }
+            waiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    static void wake(std::atomic<bool>& waiting, std::atomic<uint32_t>& epoch) {
+        if constexpr (Wait == WaitStrategy::FUTEX) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting.load(std::memory_order_relaxed)) {
+                epoch.fetch_add(1, std::memory_order_release);
+                epoch.notify_one();
+            }
+        }
+    }
+
+    // 消费者独占
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+    // 生产者独占
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+    // 等待/唤醒状态
+    alignas(CACHE_LINE) std::atomic<bool> consumer_waiting_{false};
+    std::atomic<uint32_t> consumer_epoch_{0};
+    alignas(CACHE_LINE) std::atomic<bool> producer_waiting_{false};
+    std::atomic<uint32_t> producer_epoch_{0};
+    std::atomic<bool> stopped_{false};
+
+    alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+};
+
+#endif //SPSCRINGBUFFER_H
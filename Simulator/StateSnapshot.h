@@ -0,0 +1,103 @@
+//
+// Created by fyh on 25-8-13.
+//
+
+#ifndef STATESNAPSHOT_H
+#define STATESNAPSHOT_H
+#pragma once
+
+#include "DynamicModel/KinematicState.h"
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 定时器线程每个周期发布一次的一致性状态快照
+struct StateSnapshot {
+    KinematicState state;
+    unsigned long long tick = 0;      // 已完成的仿真周期数
+    double simulation_time_ms = 0.0;  // 对应的仿真时刻 (2006-01-01 起的毫秒数)
+};
+
+// 读端争用统计
+struct SeqLockStats {
+    unsigned long long reads = 0;
+    unsigned long long retries = 0; // 因写入进行中而重读的次数
+};
+
+/**
+ * @brief 单写者顺序锁 (seqlock)。
+ *
+ * 写者从不等待读者；读者在与写入重叠时自动重试，保证拿到的是某次完整写入的结果。
+ * 数据按 8 字节原子字存储，避免读写竞争带来的未定义行为。
+ * @tparam T 可平凡拷贝的数据类型
+ */
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() {
+        store(T{});
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // 写者：只能由单一线程调用
+    void store(const T& value) {
+        std::array<uint64_t, WORDS> buffer{};
+        std::memcpy(buffer.data(), &value, sizeof(T));
+
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed); // 奇数：写入进行中
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 读者：任意线程，不阻塞写者
+    T load() const {
+        std::array<uint64_t, WORDS> buffer{};
+        unsigned long long retries = 0;
+        for (;;) {
+            const uint64_t seq_begin = sequence_.load(std::memory_order_acquire);
+            if ((seq_begin & 1u) == 0) {
+                for (size_t i = 0; i < WORDS; ++i) {
+                    buffer[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence_.load(std::memory_order_relaxed) == seq_begin) {
+                    break;
+                }
+            }
+            ++retries;
+        }
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        if (retries != 0) {
+            retries_.fetch_add(retries, std::memory_order_relaxed);
+        }
+
+        // T 可能带有默认成员初始值（如 StateSnapshot），经 void* 拷贝；平凡可拷贝已由 static_assert 保证
+        T value;
+        std::memcpy(static_cast<void*>(&value), buffer.data(), sizeof(T));
+        return value;
+    }
+
+    SeqLockStats stats() const {
+        return {reads_.load(std::memory_order_relaxed), retries_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, WORDS> words_{};
+    alignas(64) mutable std::atomic<unsigned long long> reads_{0};
+    mutable std::atomic<unsigned long long> retries_{0};
+};
+
+#endif //STATESNAPSHOT_H
@@ -0,0 +1,205 @@
+#include "StreamValidator.h"
+#include "TrainCommunicator/Protocol.h"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+constexpr uint64_t COMMAND_WORD_MASK = ~0xFFFFULL;
+constexpr uint64_t COMMAND_WORD_BASE = 0x000000000ABC0000ULL;
+} // namespace
+
+bool StreamReport::clean() const {
+    if (bad_header != 0 || bad_payload != 0) {
+        return false;
+    }
+    for (const UserStreamReport& user : users) {
+        if (user.missing != 0 || user.out_of_order != 0 || user.time_regressions != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StreamReport::print(std::ostream& os) const {
+    char line[200];
+    std::snprintf(line, sizeof(line),
+                  "datagrams %llu (%llu bytes): START %llu, STOP %llu, trajectory %llu, bad header %llu, bad payload %llu\n",
+                  datagrams, bytes, start_commands, stop_commands, trajectory_frames, bad_header, bad_payload);
+    os << line;
+    for (size_t i = 0; i < users.size(); ++i) {
+        const UserStreamReport& user = users[i];
+        std::snprintf(line, sizeof(line),
+                      "  user%zu id=%u frames %llu seq %llu..%llu missing %llu out-of-order %llu time regressions %llu\n",
+                      i + 1, user.trajectory_id, user.frames, user.first_seq, user.last_seq,
+                      user.missing, user.out_of_order, user.time_regressions);
+        os << line;
+    }
+    std::snprintf(line, sizeof(line), "%-14s %10s %10s %10s %10s %10s %10s %10s\n",
+                  "timing(us)", "count", "min", "mean", "p50", "p99", "p99.9", "max");
+    os << line;
+    auto print_summary = [&](const char* name, const LatencySummary& s) {
+        std::snprintf(line, sizeof(line), "%-14s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                      name, s.count, s.min_ns / 1000.0, s.mean_ns / 1000.0, s.p50_ns / 1000.0,
+                      s.p99_ns / 1000.0, s.p999_ns / 1000.0, s.max_ns / 1000.0);
+        os << line;
+    };
+    print_summary("inter_arrival", inter_arrival);
+    print_summary("jitter", jitter);
+    std::snprintf(line, sizeof(line), "smoothed jitter %.1f us, %.3f s, %.1f frames/s, %.1f KB/s\n",
+                  smoothed_jitter_ns / 1000.0, duration_sec, frames_per_sec, bytes_per_sec / 1024.0);
+    os << line;
+}
+
+StreamValidator::StreamValidator() {
+    reset();
+}
+
+void StreamValidator::reset() {
+    counters_ = StreamReport{};
+    users_.clear();
+    expected_users_ = 0;
+    inter_arrival_.reset();
+    jitter_.reset();
+    smoothed_jitter_ns_ = 0.0;
+    first_arrival_ns_ = -1;
+    last_arrival_ns_ = -1;
+    last_frame_time_ = 0.0;
+    trajectory_bytes_ = 0;
+}
+
+DatagramKind StreamValidator::on_datagram(const void* data, size_t size, long long arrival_ns) {
+    ++counters_.datagrams;
+    counters_.bytes += size;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    if (size < NetworkFrameHeaderLayout::size) {
+        ++counters_.bad_header;
+        return DatagramKind::INVALID;
+    }
+    const NetworkFrameHeader header = NetworkFrameHeaderLayout::read(bytes);
+    if (header.frame_flag != NETWORK_FRAME_FLAG || header.frame_length != size - NetworkFrameHeaderLayout::size) {
+        ++counters_.bad_header;
+        return DatagramKind::INVALID;
+    }
+
+    const unsigned char* payload = bytes + NetworkFrameHeaderLayout::size;
+    const size_t payload_size = header.frame_length;
+    // 指令以 8 字节指令字开头；轨迹数据开头是 trajectory_type/trajectory_id，不会落在指令字范围内
+    if (payload_size >= sizeof(uint64_t)) {
+        const uint64_t command_word = StartCommandHeaderLayout::get<&StartCommand::command_word>(payload);
+        if ((command_word & COMMAND_WORD_MASK) == COMMAND_WORD_BASE) {
+            return on_command(command_word, payload, payload_size);
+        }
+    }
+    return on_trajectory(payload, payload_size, arrival_ns);
+}
+
+DatagramKind StreamValidator::on_command(uint64_t command_word, const unsigned char* payload, size_t size) {
+    if (command_word == COMMAND_STOP) {
+        if (size != StopCommandLayout::size
+            || StopCommandLayout::get<&StopCommand::data_length>(payload) != StopCommandLayout::size) {
+            ++counters_.bad_payload;
+            return DatagramKind::INVALID;
+        }
+        ++counters_.stop_commands;
+        return DatagramKind::STOP;
+    }
+
+    // START：32B 头 + N × 200B 用户块，单/双用户由指令字区分，N 用户扩展由 data_length 给出
+    const size_t user_count = start_command_user_count(command_word, size);
+    if (user_count == 0 || StartCommandHeaderLayout::get<&StartCommand::data_length>(payload) != size) {
+        ++counters_.bad_payload;
+        return DatagramKind::INVALID;
+    }
+    ++counters_.start_commands;
+    // 新一次仿真：序号与时间重新开始，之后每帧应恰好包含 user_count 个用户块
+    users_.clear();
+    expected_users_ = user_count;
+    last_arrival_ns_ = -1;
+    return DatagramKind::START;
+}
+
+DatagramKind StreamValidator::on_trajectory(const unsigned char* payload, size_t size, long long arrival_ns) {
+    if (size == 0 || size % TrajectoryDataLayout::size != 0
+        || (expected_users_ != 0 && size != expected_users_ * TrajectoryDataLayout::size)) {
+        ++counters_.bad_payload;
+        return DatagramKind::INVALID;
+    }
+    const size_t user_count = size / TrajectoryDataLayout::size;
+    if (users_.size() < user_count) {
+        users_.resize(user_count);
+    }
+    ++counters_.trajectory_frames;
+    trajectory_bytes_ += size + NetworkFrameHeaderLayout::size;
+
+    double frame_time = 0.0;
+    for (size_t i = 0; i < user_count; ++i) {
+        const TrajectoryData data = TrajectoryDataLayout::read(payload + i * TrajectoryDataLayout::size);
+        UserState& user = users_[i];
+        UserStreamReport& report = user.report;
+        if (i == 0) {
+            frame_time = data.trajectory_time;
+        }
+        if (!user.seen) {
+            user.seen = true;
+            report.trajectory_id = data.trajectory_id;
+            report.first_seq = data.trajectory_data_seq_num;
+            report.last_seq = data.trajectory_data_seq_num;
+            user.last_time = data.trajectory_time;
+            ++report.frames;
+            continue;
+        }
+        ++report.frames;
+        if (data.trajectory_id != report.trajectory_id) {
+            ++report.id_changes;
+            report.trajectory_id = data.trajectory_id;
+        }
+        if (data.trajectory_data_seq_num > report.last_seq) {
+            report.missing += data.trajectory_data_seq_num - report.last_seq - 1;
+            report.last_seq = data.trajectory_data_seq_num;
+        } else {
+            ++report.out_of_order;
+        }
+        if (!(data.trajectory_time > user.last_time)) {
+            ++report.time_regressions;
+        }
+        user.last_time = data.trajectory_time;
+    }
+
+    if (first_arrival_ns_ < 0) {
+        first_arrival_ns_ = arrival_ns;
+    }
+    if (last_arrival_ns_ >= 0) {
+        const long long delta_ns = arrival_ns - last_arrival_ns_;
+        inter_arrival_.record(delta_ns);
+        // 到达间隔与发送端声明的时间间隔之差即为网络与调度引入的抖动
+        const double deviation_ns = std::fabs(static_cast<double>(delta_ns) - (frame_time - last_frame_time_) * 1e9);
+        jitter_.record(static_cast<long long>(deviation_ns));
+        smoothed_jitter_ns_ += (deviation_ns - smoothed_jitter_ns_) / 16.0;
+    }
+    last_arrival_ns_ = arrival_ns;
+    last_frame_time_ = frame_time;
+    return DatagramKind::TRAJECTORY;
+}
+
+unsigned long long StreamValidator::last_seq(size_t user) const {
+    return user < users_.size() ? users_[user].report.last_seq : 0;
+}
+
+StreamReport StreamValidator::report() const {
+    StreamReport result = counters_;
+    result.users.reserve(users_.size());
+    for (const UserState& user : users_) {
+        result.users.push_back(user.report);
+    }
+    result.inter_arrival = inter_arrival_.summary();
+    result.jitter = jitter_.summary();
+    result.smoothed_jitter_ns = smoothed_jitter_ns_;
+    if (first_arrival_ns_ >= 0 && last_arrival_ns_ > first_arrival_ns_) {
+        result.duration_sec = static_cast<double>(last_arrival_ns_ - first_arrival_ns_) / 1e9;
+        // 首帧只标记起点，吞吐按其后的帧计算
+        result.frames_per_sec = static_cast<double>(result.trajectory_frames - 1) / result.duration_sec;
+        result.bytes_per_sec = static_cast<double>(trajectory_bytes_) * (result.frames_per_sec / static_cast<double>(result.trajectory_frames));
+    }
+    return result;
+}
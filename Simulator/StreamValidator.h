@@ -0,0 +1,102 @@
+//
+// Created by fyh on 25-8-20.
+//
+
+#ifndef STREAMVALIDATOR_H
+#define STREAMVALIDATOR_H
+#pragma once
+
+#include "TickHistogram.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 报文解码结果
+enum class DatagramKind {
+    INVALID,
+    START,
+    STOP,
+    TRAJECTORY
+};
+
+// 数据包中第 index 个用户的数据流统计
+struct UserStreamReport {
+    unsigned int trajectory_id = 0;
+    unsigned long long frames = 0;
+    unsigned long long first_seq = 0;
+    unsigned long long last_seq = 0;
+    unsigned long long missing = 0;          // 序号跳跃累计缺失的帧数
+    unsigned long long out_of_order = 0;     // 序号不增（重复或乱序）的帧数
+    unsigned long long time_regressions = 0; // trajectory_time 不增的帧数
+    unsigned long long id_changes = 0;       // 同一位置上 trajectory_id 变化的次数
+};
+
+// 接收端对整条报文流的校验与计时结果
+struct StreamReport {
+    unsigned long long datagrams = 0;
+    unsigned long long bytes = 0;
+    unsigned long long bad_header = 0;       // 帧头标识错误或 frame_length 与报文长度不符
+    unsigned long long bad_payload = 0;      // 帧头正确但载荷长度或内容不符合任何已知报文（含用户数与 START 不符的轨迹帧）
+    unsigned long long start_commands = 0;
+    unsigned long long stop_commands = 0;
+    unsigned long long trajectory_frames = 0;
+    std::vector<UserStreamReport> users;
+
+    LatencySummary inter_arrival;            // 相邻轨迹帧到达间隔
+    LatencySummary jitter;                   // |到达间隔 - trajectory_time 间隔|
+    double smoothed_jitter_ns = 0.0;         // RFC 3550 风格的指数平滑抖动
+    double duration_sec = 0.0;               // 首个到最后一个轨迹帧的时间跨度
+    double frames_per_sec = 0.0;
+    double bytes_per_sec = 0.0;
+
+    bool clean() const;                      // 没有任何格式错误、缺失、乱序或时间倒退
+    void print(std::ostream& os) const;
+};
+
+/**
+ * @brief 按网络注入协议解码报文流并做一致性检查，与传输方式无关（实时接收与离线回放共用）。
+ *
+ * 识别 START（0x0ABC0000 + N 用户）、STOP 与 N × 248B 的轨迹数据包；START 会清空各用户的
+ * 序号状态，使一次仿真内的序号缺失与 trajectory_time 倒退从 1 开始统计。非线程安全。
+ */
+class StreamValidator {
+public:
+    StreamValidator();
+
+    void reset();
+
+    /**
+     * @brief 处理一个完整的 UDP 报文（含网络帧头）。
+     * @param arrival_ns 到达时刻，用于计算到达间隔、抖动与吞吐
+     */
+    DatagramKind on_datagram(const void* data, size_t size, long long arrival_ns);
+
+    StreamReport report() const;
+    unsigned long long trajectory_frames() const { return counters_.trajectory_frames; }
+    // 第 user 个用户最近的序号，尚未收到时为 0
+    unsigned long long last_seq(size_t user) const;
+
+private:
+    struct UserState {
+        UserStreamReport report;
+        double last_time = 0.0;
+        bool seen = false;
+    };
+
+    DatagramKind on_command(uint64_t command_word, const unsigned char* payload, size_t size);
+    DatagramKind on_trajectory(const unsigned char* payload, size_t size, long long arrival_ns);
+
+    StreamReport counters_;
+    std::vector<UserState> users_;
+    size_t expected_users_ = 0;              // 最近一次 START 的用户数，0 表示未见 START
+    LatencyHistogram inter_arrival_;
+    LatencyHistogram jitter_;
+    double smoothed_jitter_ns_ = 0.0;
+    long long first_arrival_ns_ = -1;
+    long long last_arrival_ns_ = -1;
+    double last_frame_time_ = 0.0;
+    unsigned long long trajectory_bytes_ = 0;
+};
+
+#endif //STREAMVALIDATOR_H
@@ -0,0 +1,191 @@
+//
+// Created by fyh on 25-8-18.
+//
+
+#ifndef TICKHISTOGRAM_H
+#define TICKHISTOGRAM_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+
+// 直方图摘要，单位 ns
+struct LatencySummary {
+    unsigned long long count = 0;
+    long long min_ns = 0;
+    long long max_ns = 0;
+    double mean_ns = 0.0;
+    long long p50_ns = 0;
+    long long p90_ns = 0;
+    long long p99_ns = 0;
+    long long p999_ns = 0;
+};
+
+/**
+ * @brief HDR 风格的对数-线性直方图（单写者，任意线程可读）。
+ *
+ * 每个 2 的幂区间再线性划分为 32 个子桶，相对误差不超过 1/32；覆盖 0 ~ 2^45 ns。
+ * 记录只有一次位运算和几次 relaxed 原子读写，不加锁、不分配内存。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr int MAX_MAGNITUDE = 45;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT * (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2);
+
+    // 仅由写者线程调用
+    void record(long long value_ns) {
+        const uint64_t value = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+        auto& bucket = buckets_[index_of(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+        if (value < min_.load(std::memory_order_relaxed)) {
+            min_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // 写者未运行时调用
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 生成摘要。与写者并发时各字段可能相差最近几次记录，不影响统计意义。
+     * 分位数取所在桶的上界，保证不低估。
+     */
+    LatencySummary summary() const {
+        LatencySummary result;
+        std::array<uint64_t, BUCKET_COUNT> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return result;
+        }
+        result.count = total;
+        result.min_ns = static_cast<long long>(min_.load(std::memory_order_relaxed));
+        result.max_ns = static_cast<long long>(max_.load(std::memory_order_relaxed));
+        result.mean_ns = static_cast<double>(sum_.load(std::memory_order_relaxed))
+                         / static_cast<double>(count_.load(std::memory_order_relaxed));
+
+        const double quantiles[4] = {0.50, 0.90, 0.99, 0.999};
+        long long* targets[4] = {&result.p50_ns, &result.p90_ns, &result.p99_ns, &result.p999_ns};
+        uint64_t cumulative = 0;
+        int q = 0;
+        for (size_t i = 0; i < BUCKET_COUNT && q < 4; ++i) {
+            cumulative += counts[i];
+            while (q < 4 && static_cast<double>(cumulative) >= quantiles[q] * static_cast<double>(total)) {
+                *targets[q] = std::min(static_cast<long long>(upper_bound_of(i)), result.max_ns);
+                ++q;
+            }
+        }
+        return result;
+    }
+
+private:
+    static size_t index_of(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        const int magnitude = std::bit_width(value) - 1;
+        if (magnitude > MAX_MAGNITUDE) {
+            return BUCKET_COUNT - 1;
+        }
+        const int shift = magnitude - SUB_BUCKET_BITS;
+        const uint64_t sub = (value >> shift) - SUB_BUCKET_COUNT;
+        return static_cast<size_t>(SUB_BUCKET_COUNT * (shift + 1) + sub);
+    }
+
+    static uint64_t upper_bound_of(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        const auto shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+        const uint64_t sub = index % SUB_BUCKET_COUNT;
+        return ((SUB_BUCKET_COUNT + sub + 1) << shift) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+};
+
+// 仿真周期内被计时的阶段
+enum class TickStage : int {
+    WAKE_LATENESS = 0, // 实际唤醒时刻相对期望时刻的滞后
+    CONTROL,           // 指令处理 + 动力学推进 + 状态发布
+    ROUTE,             // 线路插值与数据包填充
+    SEND,              // UDP 发送
+    TOTAL,             // 回调总耗时
+    COUNT
+};
+
+inline const char* tick_stage_name(TickStage stage) {
+    switch (stage) {
+        case TickStage::WAKE_LATENESS: return "wake_lateness";
+        case TickStage::CONTROL:       return "control";
+        case TickStage::ROUTE:         return "route";
+        case TickStage::SEND:          return "send";
+        case TickStage::TOTAL:         return "tick_total";
+        default:                       return "unknown";
+    }
+}
+
+// 仿真周期各阶段的直方图集合
+class TickInstrumentation {
+public:
+    void record(TickStage stage, long long value_ns) {
+        histograms_[static_cast<int>(stage)].record(value_ns);
+    }
+
+    void reset() {
+        for (auto& histogram : histograms_) {
+            histogram.reset();
+        }
+    }
+
+    LatencySummary summary(TickStage stage) const {
+        return histograms_[static_cast<int>(stage)].summary();
+    }
+
+    void print(std::ostream& os) const {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-14s %10s %10s %10s %10s %10s %10s %10s\n",
+                      "stage(us)", "count", "min", "mean", "p50", "p99", "p99.9", "max");
+        os << line;
+        for (int i = 0; i < static_cast<int>(TickStage::COUNT); ++i) {
+            const LatencySummary s = histograms_[i].summary();
+            std::snprintf(line, sizeof(line), "%-14s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                          tick_stage_name(static_cast<TickStage>(i)), s.count,
+                          s.min_ns / 1000.0, s.mean_ns / 1000.0, s.p50_ns / 1000.0,
+                          s.p99_ns / 1000.0, s.p999_ns / 1000.0, s.max_ns / 1000.0);
+            os << line;
+        }
+    }
+
+private:
+    std::array<LatencyHistogram, static_cast<int>(TickStage::COUNT)> histograms_;
+};
+
+#endif //TICKHISTOGRAM_H
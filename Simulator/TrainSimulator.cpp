@@ -1,115 +1,271 @@
 #include "TrainSimulator.h"
+#include "EnergyOptimizer.h"
+#include "TextEncoding.h"
+#include "TrainCommunicator/TickScheduler.h"
 #include <iostream>
 #include <functional>
 #include <chrono>
 #include <thread>
 #include <stdexcept>
 #include <algorithm>
-
-namespace {
-std::string narrow(const std::wstring& w) {
-    return std::string(w.begin(), w.end());
-}
-
-double clamp_center(double s_center, double train_length, double route_length) {
-    const double half_len = train_length * 0.5;
-    const double min_s = half_len;
-    const double max_s = std::max(half_len, route_length - half_len);
-    return std::clamp(s_center, min_s, max_s);
-}
-} // namespace
+#include <cstdio>
 
 TrainSimulator::TrainSimulator(const SimulatorConfiguration& config)
-    : config_(config),
-      udp_comm(narrow(config.ip), config.port),
-      trajectory_sequence_numbers_{0, 0},
-      simulation_start_time_(config.simulation_start_time) {
+    : simulation_start_time_(config.simulation_start_time),
+      udp_comm(to_utf8(config.ip), config.port),
+      config_(config),
+      consist_(route, ConsistTrajectory::resolve(config), config.test_vehicle.trainLong) {
 
     std::cout << "正在使用配置构造TrainSimulator..." << std::endl;
-    const std::string route_path = narrow(config_.route_file);
+    for (const UdpDestination& destination : config_.extra_destinations) {
+        if (!udp_comm.add_destination(to_utf8(destination.ip), destination.port)) {
+            throw std::runtime_error("无效的UDP目的地址: " + to_utf8(destination.ip));
+        }
+    }
+    if (!config_.extra_destinations.empty()) {
+        udp_comm.set_multicast_ttl(config_.multicast_ttl);
+    }
+    if (config_.send_backend != SendBackend::SENDMSG && !udp_comm.set_send_backend(config_.send_backend)) {
+        std::cerr << "警告：" << send_backend_name(config_.send_backend) << " 发送后端不可用，回退到 sendmsg" << std::endl;
+    }
+    const std::string route_path = to_utf8(config_.route_file);
     if (!route.loadFromFile(route_path)) {
         throw std::runtime_error("加载路线文件失败: " + route_path);
     }
     std::cout << "路线加载成功。总距离：" << route.getTotalDistance() << "米" << std::endl;
 
-    train_controller_ptr = std::make_unique<TrainController>(config_.test_vehicle, route.getTotalDistance());
+    train_controller_ptr = std::make_unique<TrainController>(config_.test_vehicle, route.getTotalDistance(), &route.getTrackProfile());
     std::cout << "列车控制器初始化完成" << std::endl;
 
+    if (config_.energy_optimal_trip_time > 0.0) {
+        const EnergyOptimizationResult plan =
+            EnergyOptimizer(route, config_.test_vehicle).optimize(config_.energy_optimal_trip_time);
+        std::cout << "节能驾驶剖面优化完成：运行时分 " << plan.trip_time << "s，单位牵引能耗 "
+                  << plan.traction_energy << "J/kg" << (plan.meets_target ? "" : "（目标时分不可达）") << std::endl;
+        train_controller_ptr->setDrivingProfile(std::make_shared<DrivingProfile>(plan.profile));
+    }
+    publish_state(train_controller_ptr->getCurrentState(), 0);
+
     timer.setInterval(config_.SIMULATION_INTERVAL_MS);
-    timer.setCallback([this]() {
+    timer.setOverrunPolicy(config_.timer_overrun_policy);
+    timer.setPhase(config_.timer_phase_us);
+    if (config_.use_shared_scheduler) {
+        timer.setScheduler(TickScheduler::shared());
+    }
+    configure_clock(config_.clock_mode, config_.clock_scale);
+    if (config_.enable_feedback) {
+        enable_feedback(config_.ack_timeout_ms);
+    }
+    if (!config_.capture_file.empty() && !start_capture(to_utf8(config_.capture_file))) {
+        throw std::runtime_error("无法创建捕获文件: " + to_utf8(config_.capture_file));
+    }
+    if (config_.realtime.enabled) {
+        if (config_.use_shared_scheduler) {
+            // 共享调度线程由多个实例共用，不对其施加本实例的调度策略与亲和性，只预先触碰本实例的内存
+            std::cerr << "警告：共享调度器模式下不应用线程级实时配置" << std::endl;
+            prefault_working_set();
+        } else {
+            timer.setThreadInitializer([this]() { prepare_realtime(); });
+        }
+    }
+    timer.setCallback([this]() { on_tick(); });
+    packet_pipeline_ = std::make_unique<LookaheadPipeline<PreparedPacket, PipelineQueue>>([this](PreparedPacket& packet) {
+        // 预计算线程按周期序号逐个推进，每个数据包恰好对应一个仿真步长
         const double dt = static_cast<double>(config_.SIMULATION_INTERVAL_MS) / 1000.0;
+        prepare_packet(++pipeline_tick_, dt, packet);
+    });
+    std::cout << "TrainSimulator构造成功，回调已设置" << std::endl;
+}
 
-        train_controller_ptr->update(dt);
-        const KinematicState state_1d = train_controller_ptr->getCurrentState();
+TrainSimulator::~TrainSimulator() {
+    timer.stop();
+    stop_table_generator();
+    packet_pipeline_->stop();
+    udp_comm.stop_receiver();
+    stop_capture();
+}
+
+void TrainSimulator::on_tick() {
+    const long long tick_begin_ns = MillisecondTimer::now_ns();
+    tick_stats_.record(TickStage::WAKE_LATENESS, timer.get_last_lateness_ns());
+    const unsigned long long tick_index = timer.get_tick_index();
+
+    if (trajectory_table_) {
+        send_table_record(tick_index, tick_begin_ns);
+        return;
+    }
+    if (config_.pipeline_depth > 0) {
+        // 直接从环形缓冲槽位发送预先算好的帧；SKIP 策略下丢弃期望时刻已错过的包
+        while (true) {
+            PreparedPacket* packet = packet_pipeline_->try_acquire();
+            if (packet == nullptr) {
+                pipeline_underruns_.fetch_add(1, std::memory_order_relaxed);
+                packet = packet_pipeline_->acquire();
+                if (packet == nullptr) {
+                    return;
+                }
+            }
+            if (packet->tick >= tick_index) {
+                send_packet(*packet, tick_begin_ns);
+                packet_pipeline_->release();
+                return;
+            }
+            packet_pipeline_->release();
+        }
+    }
 
-        const double route_length = route.getTotalDistance();
-        const double half_len = config_.test_vehicle.trainLong * 0.5;
-        const double clamped_center_s = clamp_center(state_1d.position, config_.test_vehicle.trainLong, route_length);
-        const bool clamped = clamped_center_s != state_1d.position;
+    // SKIP 策略下周期序号可能跳跃，动力学按实际经过的周期数推进
+    const double dt = static_cast<double>(config_.SIMULATION_INTERVAL_MS) / 1000.0;
+    const unsigned long long elapsed_ticks = tick_index > tick_count_ ? tick_index - tick_count_ : 1;
+    tick_count_ = tick_index;
+    prepare_packet(tick_index, static_cast<double>(elapsed_ticks) * dt, ready_packet_);
+    send_packet(ready_packet_, tick_begin_ns);
+}
 
-        const double tangential_speed = clamped ? 0.0 : state_1d.velocity;
-        const double tangential_acc = clamped ? 0.0 : state_1d.acceleration;
-        const double tangential_jerk = clamped ? 0.0 : state_1d.jerk;
+void TrainSimulator::prepare_packet(unsigned long long tick_index, double advance_sec, PreparedPacket& packet) {
+    const long long control_begin_ns = MillisecondTimer::now_ns();
+    const double dt = static_cast<double>(config_.SIMULATION_INTERVAL_MS) / 1000.0;
+
+    apply_pending_commands();
+    train_controller_ptr->update(advance_sec);
+    const KinematicState state_1d = train_controller_ptr->getCurrentState();
+    packet.tick = tick_index;
+    packet.state = state_1d;
+    const long long control_end_ns = MillisecondTimer::now_ns();
+    tick_stats_.record(TickStage::CONTROL, control_end_ns - control_begin_ns);
+
+    // 序号在发送时写入，流水线中被丢弃的包不占序号
+    const size_t payload_size = consist_.write(state_1d, static_cast<double>(tick_index - 1) * dt, 0,
+                                               packet.frame.payload_bytes());
+    packet.frame_size = packet.frame.set_payload_length(static_cast<uint32_t>(payload_size));
+    tick_stats_.record(TickStage::ROUTE, MillisecondTimer::now_ns() - control_end_ns);
+}
 
-        const double s_head = std::min(route_length, clamped_center_s + half_len);
-        const double s_tail = std::max(0.0, clamped_center_s - half_len);
+void TrainSimulator::send_packet(PreparedPacket& packet, long long tick_begin_ns) {
+    ConsistTrajectory::set_sequence(packet.frame.payload_bytes(), consist_.user_count(), ++frame_sequence_);
+    send_trajectory_frame(reinterpret_cast<const unsigned char*>(&packet.frame), packet.frame_size,
+                          packet.state, packet.tick, tick_begin_ns);
+}
 
-        const unsigned long long seq_user1 = ++trajectory_sequence_numbers_[0];
-        unsigned long long seq_user2 = 0;
-        if (config_.enable_second_user) {
-            seq_user2 = ++trajectory_sequence_numbers_[1];
+void TrainSimulator::send_trajectory_frame(const unsigned char* frame, size_t frame_size, const KinematicState& state,
+                                           unsigned long long tick, long long tick_begin_ns) {
+    const long long send_begin_ns = MillisecondTimer::now_ns();
+    udp_comm.send_frame(frame, frame_size);
+    const long long send_end_ns = MillisecondTimer::now_ns();
+    if (feedback_enabled_.load(std::memory_order_relaxed)) {
+        feedback_.trajectory_sent(
+            TrajectoryDataLayout::get<&TrajectoryData::trajectory_data_seq_num>(frame + NetworkFrameHeaderLayout::size),
+            send_end_ns);
+    }
+    publish_state(state, tick);
+    tick_stats_.record(TickStage::SEND, send_end_ns - send_begin_ns);
+    tick_stats_.record(TickStage::TOTAL, send_end_ns - tick_begin_ns);
+}
+
+void TrainSimulator::send_table_record(unsigned long long tick_index, long long tick_begin_ns) {
+    const long long read_begin_ns = MillisecondTimer::now_ns();
+    TrajectoryTable& table = *trajectory_table_;
+    unsigned long long record = std::min(tick_index, table.tick_count());
+    if (table.ready() < record) {
+        // 后台生成落后于播放（只可能发生在分块生成时）：最多等到半个周期，仍未发布则重发最近一条已生成的记录
+        table_underruns_.fetch_add(1, std::memory_order_relaxed);
+        const long long deadline_ns = tick_begin_ns + config_.SIMULATION_INTERVAL_MS * 1000000LL / 2;
+        while (table.ready() < record && MillisecondTimer::now_ns() < deadline_ns) {
+            std::this_thread::yield();
+        }
+        const unsigned long long ready = table.ready();
+        if (ready < record) {
+            table_repeats_.fetch_add(1, std::memory_order_relaxed);
+            record = ready; // 首块在定时器启动前已生成，ready 至少为 1
         }
+    }
 
-        auto fill_user_data = [&](TrajectoryData& user_data,
-                                  unsigned int trajectory_id,
-                                  unsigned int trajectory_type,
-                                  unsigned long long seq_number,
-                                  double s_sample) {
-            user_data.trajectory_data_seq_num = seq_number;
-            user_data.trajectory_time = (seq_number - 1) * dt;
-            user_data.trajectory_id = trajectory_id;
-            user_data.trajectory_type = trajectory_type;
-
-            const ECEFPoint pos_3d = route.getPositionAt(s_sample);
-            const ECEFPoint vel_3d = route.getVelocityAt(s_sample, tangential_speed);
-            const ECEFPoint acc_3d = route.getAccelerationAt(s_sample, tangential_speed, tangential_acc);
-            const ECEFPoint jerk_3d = route.getJerkAt(s_sample, tangential_speed, tangential_acc, tangential_jerk);
-
-            user_data.user_pos_x = pos_3d.x; user_data.user_pos_y = pos_3d.y; user_data.user_pos_z = pos_3d.z;
-            user_data.user_vel_x = vel_3d.x; user_data.user_vel_y = vel_3d.y; user_data.user_vel_z = vel_3d.z;
-            user_data.user_acc_x = acc_3d.x; user_data.user_acc_y = acc_3d.y; user_data.user_acc_z = acc_3d.z;
-            user_data.user_jerk_x = jerk_3d.x; user_data.user_jerk_y = jerk_3d.y; user_data.user_jerk_z = jerk_3d.z;
-        };
-
-        if (config_.enable_second_user) {
-            DualTrajectoryData dual_packet{};
-            fill_user_data(dual_packet.user1,
-                           static_cast<unsigned int>(config_.trajectory_ID),
-                           static_cast<unsigned int>(config_.trajectory_type),
-                           seq_user1,
-                           s_head);
-            fill_user_data(dual_packet.user2,
-                           static_cast<unsigned int>(config_.trajectory_ID_user2),
-                           static_cast<unsigned int>(config_.trajectory_type_user2),
-                           seq_user2,
-                           s_tail);
-
-            udp_comm.send(&dual_packet, sizeof(dual_packet));
-        } else {
-            TrajectoryData single_packet{};
-            fill_user_data(single_packet,
-                           static_cast<unsigned int>(config_.trajectory_ID),
-                           static_cast<unsigned int>(config_.trajectory_type),
-                           seq_user1,
-                           s_head);
-            udp_comm.send(&single_packet, sizeof(single_packet));
+    // 记录已是完整的线上帧；序号与实时计算、流水线共用 frame_sequence_，按实际发出的帧连续编号
+    unsigned char* payload = table.payload(record);
+    ConsistTrajectory::set_sequence(payload, table.user_count(), ++frame_sequence_);
+    if (record != tick_index) {
+        // 超出表尾或重发的记录：轨迹时间仍按当前周期写入
+        const double trajectory_time = static_cast<double>(tick_index - 1) * config_.SIMULATION_INTERVAL_MS / 1000.0;
+        for (size_t i = 0; i < table.user_count(); ++i) {
+            TrajectoryDataLayout::set<&TrajectoryData::trajectory_time>(payload + i * TrajectoryDataLayout::size,
+                                                                        trajectory_time);
         }
-    });
-    std::cout << "TrainSimulator构造成功，回调已设置" << std::endl;
+    }
+    table_played_ = record;
+    tick_stats_.record(TickStage::ROUTE, MillisecondTimer::now_ns() - read_begin_ns);
+    send_trajectory_frame(table.frame(record), table.frame_size(), table.state(record), tick_index, tick_begin_ns);
 }
 
-TrainSimulator::~TrainSimulator() {
-    timer.stop();
+bool TrainSimulator::build_trajectory_table() {
+    const long long interval_ms = config_.SIMULATION_INTERVAL_MS;
+    if (config_.simulation_duration <= 0 || interval_ms <= 0) {
+        std::cerr << "警告：仿真时长未设置，无法预计算轨迹表，改为实时计算" << std::endl;
+        return false;
+    }
+    const auto tick_count = static_cast<unsigned long long>((config_.simulation_duration + interval_ms - 1) / interval_ms);
+    try {
+        trajectory_table_ = std::make_unique<TrajectoryTable>(to_utf8(config_.trajectory_table_file), tick_count,
+                                                              consist_.user_count(), config_.SIMULATION_INTERVAL_MS);
+    } catch (const std::exception& e) {
+        std::cerr << "警告：" << e.what() << "，改为实时计算" << std::endl;
+        return false;
+    }
+
+    // 在控制器副本上生成，仿真自身的控制器保持在发车状态，停止时再追到已播放的周期
+    table_controller_ = std::make_unique<TrainController>(*train_controller_ptr);
+    table_generator_stop_ = false;
+    const long long begin_ns = MillisecondTimer::now_ns();
+    const unsigned long long first_chunk = config_.precompute_chunk_ticks > 0
+        ? std::min(tick_count, static_cast<unsigned long long>(config_.precompute_chunk_ticks))
+        : tick_count;
+    fill_trajectory_table(1, first_chunk);
+    std::cout << "轨迹表预计算：" << first_chunk << " / " << tick_count << " 周期，耗时 "
+              << (MillisecondTimer::now_ns() - begin_ns) / 1000000 << "ms" << std::endl;
+    if (first_chunk < tick_count) {
+        table_generator_ = std::thread([this, first_chunk, tick_count]() {
+            fill_trajectory_table(first_chunk + 1, tick_count);
+        });
+    }
+    table_played_ = 0;
+    table_underruns_ = 0;
+    table_repeats_ = 0;
+    return true;
+}
+
+void TrainSimulator::fill_trajectory_table(unsigned long long first, unsigned long long last) {
+    // 与实时计算相同的推进与换算，仅把结果写入表中；序号在播放时写入
+    TrajectoryTable& table = *trajectory_table_;
+    const double dt = static_cast<double>(config_.SIMULATION_INTERVAL_MS) / 1000.0;
+    for (unsigned long long tick = first; tick <= last; ++tick) {
+        if (table_generator_stop_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        table_controller_->update(dt);
+        const KinematicState& state = table_controller_->getCurrentState();
+        table.set_state(tick, state);
+        const size_t payload_size = consist_.write(state, static_cast<double>(tick - 1) * dt, 0, table.payload(tick));
+        write_frame_header(table.frame(tick), static_cast<uint32_t>(payload_size));
+        table.publish(tick);
+    }
+}
+
+void TrainSimulator::stop_table_generator() {
+    table_generator_stop_ = true;
+    if (table_generator_.joinable()) {
+        table_generator_.join();
+    }
+}
+
+void TrainSimulator::finish_table_playback() {
+    stop_table_generator();
+    // 播放期间不接受指令，自动驾驶从发车状态确定性推进，重放相同步数即得到最后发出记录时的控制器状态
+    const double dt = static_cast<double>(config_.SIMULATION_INTERVAL_MS) / 1000.0;
+    for (unsigned long long tick = 0; tick < table_played_; ++tick) {
+        train_controller_ptr->update(dt);
+    }
+    table_played_ = 0;
+    table_controller_.reset();
+    table_playback_ = false;
 }
 
 bool TrainSimulator::start_simulation() {
@@ -119,53 +275,46 @@ bool TrainSimulator::start_simulation() {
             return false;
         }
 
+        const size_t user_count = consist_.user_count();
         StartCommand start_cmd{};
-        start_cmd.command_word = config_.enable_second_user ? 0x000000000ABC0002ULL : 0x000000000ABC0001ULL;
+        start_cmd.command_word = start_command_word(user_count);
         start_cmd.reserved_after_cmd = 0;
         start_cmd.simulation_duration = static_cast<uint64_t>(config_.simulation_duration);
         start_cmd.simulation_start_time = static_cast<uint64_t>(config_.simulation_start_time);
 
-        const double route_length = route.getTotalDistance();
-        const double half_len = config_.test_vehicle.trainLong * 0.5;
-        const double s_center0 = clamp_center(0.0, config_.test_vehicle.trainLong, route_length);
-        const double s_head0 = std::min(route_length, s_center0 + half_len);
-        const double s_tail0 = std::max(0.0, s_center0 - half_len);
-
-        const ECEFPoint pos_head = route.getPositionAt(s_head0);
-        const ECEFPoint pos_tail = route.getPositionAt(s_tail0);
-
-        auto fill_start_user = [](StartUserParams& user_params,
-                                  unsigned int trajectory_id,
-                                  unsigned int trajectory_type,
-                                  const ECEFPoint& initial_pos) {
-            user_params.trajectory_id = trajectory_id;
-            user_params.trajectory_type = trajectory_type;
-            user_params.initial_user_pos_x = initial_pos.x;
-            user_params.initial_user_pos_y = initial_pos.y;
-            user_params.initial_user_pos_z = initial_pos.z;
-        };
-
-        fill_start_user(start_cmd.users[0],
-                        static_cast<unsigned int>(config_.trajectory_ID),
-                        static_cast<unsigned int>(config_.trajectory_type),
-                        pos_head);
-
-        size_t payload_size = 32 + sizeof(StartUserParams); // 默认单用户
-
-        if (config_.enable_second_user) {
-            fill_start_user(start_cmd.users[1],
-                            static_cast<unsigned int>(config_.trajectory_ID_user2),
-                            static_cast<unsigned int>(config_.trajectory_type_user2),
-                            pos_tail);
-            payload_size = 32 + 2 * sizeof(StartUserParams);
-        }
+        std::vector<StartUserParams> users(user_count);
+        consist_.initial_users(users.data());
 
-        start_cmd.data_length = static_cast<uint32_t>(payload_size);
+        start_cmd.data_length = static_cast<uint32_t>(start_command_size(user_count));
+        std::vector<unsigned char> payload(start_command_size(user_count));
+        const size_t payload_size = serialize_start_command(start_cmd, users.data(), user_count, payload.data());
 
         std::cout << "准备向网络节点发送START命令..." << std::endl;
-        bool send_result = udp_comm.send(&start_cmd, payload_size);
-        std::cout << (send_result ? "START命令发送成功" : "START命令发送失败") << std::endl;
-        return send_result;
+        if (feedback_enabled_) {
+            feedback_.reset();
+            feedback_.command_sent(start_cmd.command_word, MillisecondTimer::now_ns());
+        }
+        const SendResult send_result = udp_comm.send(payload.data(), payload_size);
+        if (!send_result.ok()) {
+            std::cout << "START命令发送失败: " << send_status_name(send_result.status)
+                      << " (错误码 " << send_result.error_code << ")" << std::endl;
+            return false;
+        }
+        std::cout << "START命令发送成功" << std::endl;
+        start_sent_ = true; // 接收端已按当前时钟与目的地开始，直到 STOP 前不再允许修改
+        if (feedback_enabled_ && config_.ack_timeout_ms > 0) {
+            CommandReply reply;
+            if (!feedback_.wait_for_reply(start_cmd.command_word, config_.ack_timeout_ms, reply)) {
+                std::cout << "警告：" << config_.ack_timeout_ms << "ms 内未收到START应答" << std::endl;
+            } else if (reply.status != 0) {
+                std::cout << "START命令被模拟器拒绝，状态码 " << reply.status << std::endl;
+                start_sent_ = false;
+                return false;
+            } else {
+                std::cout << "START应答已收到，耗时 " << reply.latency_ns / 1000 << "us" << std::endl;
+            }
+        }
+        return true;
     } catch (const std::exception& e) {
         std::cerr << "发送START命令时发生异常：" << e.what() << std::endl;
         return false;
@@ -174,44 +323,156 @@ bool TrainSimulator::start_simulation() {
 
 void TrainSimulator::run_simulation_non_blocking() {
     std::cout << "Simulation timer started. Running in the background." << std::endl;
+    tick_count_ = 0; // 定时器重新启动后周期序号从 1 开始
+    frame_sequence_ = 0;
+    tick_stats_.reset();
+    // 启动前投递的指令在定时器线程接管之前生效（此时尚无消费者线程），预计算轨迹表也从这一状态开始
+    apply_pending_commands();
+    if (table_playback_) {
+        finish_table_playback();
+    }
+    stop_table_generator();
+    trajectory_table_.reset();
+    if (config_.trajectory_source == TrajectorySource::PRECOMPUTED && build_trajectory_table()) {
+        table_playback_ = true;
+    } else if (config_.pipeline_depth > 0) {
+        pipeline_tick_ = 0;
+        pipeline_underruns_ = 0;
+        packet_pipeline_->start(std::min(static_cast<size_t>(config_.pipeline_depth), MAX_PIPELINE_DEPTH));
+    }
     timer.start();
+    timer_running_ = true;
 }
 
 bool TrainSimulator::stop_simulation() {
     timer.stop();
+    timer_running_ = false;
+    packet_pipeline_->stop();
+    stop_table_generator();
+    std::cout << "仿真周期时延统计：" << std::endl;
+    tick_stats_.print(std::cout);
+    if (table_playback_) {
+        std::cout << "轨迹表播放等待生成次数：" << table_underruns_.load() << "，其中重发上一条记录 "
+                  << table_repeats_.load() << " 次" << std::endl;
+        finish_table_playback();
+    } else if (config_.pipeline_depth > 0) {
+        std::cout << "预计算流水线欠载次数：" << pipeline_underruns_.load() << std::endl;
+    }
+    // 异步发送后端需先等待在途帧完成，统计才完整
+    udp_comm.flush_sends();
+    const UdpSendStats send_stats = udp_comm.get_stats();
+    std::cout << "UDP发送统计（" << send_backend_name(udp_comm.send_backend()) << "）：成功 " << send_stats.packets_sent << " 包 / " << send_stats.bytes_sent
+              << " 字节，失败 " << send_stats.failures << " 次";
+    if (send_stats.failures > 0) {
+        std::cout << "（最近一次 " << send_status_name(send_stats.last_failure)
+                  << "，错误码 " << send_stats.last_error_code << "）";
+    }
+    std::cout << std::endl;
+    if (udp_comm.destination_count() > 1) {
+        for (const DestinationStats& destination : udp_comm.get_destination_stats()) {
+            std::cout << "  " << destination.ip << ":" << destination.port << " 成功 " << destination.packets_sent
+                      << " 包，失败 " << destination.failures << " 次";
+            if (destination.failures > 0) {
+                std::cout << "（最近错误码 " << destination.last_error_code << "）";
+            }
+            std::cout << std::endl;
+        }
+    }
+    if (feedback_enabled_) {
+        const FeedbackStats feedback = feedback_.stats();
+        std::cout << "模拟器反馈：数据流反馈 " << feedback.stream_feedback << " 次，已确认序号 "
+                  << feedback.last_acked_seq << " / 已发送 " << feedback.last_sent_seq << "，对端缺失 "
+                  << feedback.peer_lost << "，往返时延 p50 " << feedback.round_trip.p50_ns / 1000
+                  << "us / p99 " << feedback.round_trip.p99_ns / 1000 << "us" << std::endl;
+    }
     std::cout << "向网络节点发送STOP命令..." << std::endl;
     StopCommand stop_cmd{};
-    stop_cmd.command_word = 0x000000000ABC0003ULL;
+    stop_cmd.command_word = COMMAND_STOP;
     stop_cmd.reserved_after_cmd = 0;
-    stop_cmd.data_length = static_cast<uint32_t>(sizeof(StopCommand));
-    bool result = udp_comm.send(&stop_cmd, sizeof(stop_cmd));
-    std::cout << (result ? "STOP命令发送成功" : "STOP命令发送失败") << std::endl;
-    return result;
+    stop_cmd.data_length = static_cast<uint32_t>(StopCommandLayout::size);
+    if (feedback_enabled_) {
+        feedback_.command_sent(stop_cmd.command_word, MillisecondTimer::now_ns());
+    }
+    unsigned char stop_payload[StopCommandLayout::size];
+    StopCommandLayout::write(stop_cmd, stop_payload);
+    const SendResult result = udp_comm.send(stop_payload, sizeof(stop_payload));
+    start_sent_ = false;
+    if (result.ok()) {
+        std::cout << "STOP命令发送成功" << std::endl;
+    } else {
+        std::cout << "STOP命令发送失败: " << send_status_name(result.status)
+                  << " (错误码 " << result.error_code << ")" << std::endl;
+    }
+    return result.ok();
 }
 
 void TrainSimulator::print_current_status() const {
-    if (train_controller_ptr) {
-        train_controller_ptr->printCurrentState();
-    }
+    const StateSnapshot snapshot = published_state_.load();
+    printf("Tick: %llu | Pos: %9.2fm | Vel: %5.2fm/s | Accel: %4.2fm/s^2 | Jerk: %4.2fm/s^3\n",
+           snapshot.tick, snapshot.state.position, snapshot.state.velocity,
+           snapshot.state.acceleration, snapshot.state.jerk);
 }
 
 void TrainSimulator::set_control_mode(TrainController::ControlMode mode) {
-    if (train_controller_ptr) {
-        train_controller_ptr->setControlMode(mode);
-    }
+    post_command(ControlCommand::Type::SET_MODE, static_cast<int>(mode));
 }
 
 void TrainSimulator::set_control_level(TrainController::ControlLevel level) {
-    if (train_controller_ptr) {
-        train_controller_ptr->setControlLevel(level);
+    post_command(ControlCommand::Type::SET_LEVEL, static_cast<int>(level));
+}
+
+bool TrainSimulator::post_command(ControlCommand::Type type, int value) {
+    if (table_playback_) {
+        std::cerr << "警告：正在播放预计算轨迹表，控制指令不再生效" << std::endl;
+        commands_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ControlCommand command;
+    command.type = type;
+    command.value = value;
+    command.enqueue_time_ns = ControlCommand::now_ns();
+    if (!command_queue_.push(command)) {
+        commands_dropped_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "警告：控制指令队列已满，指令被丢弃" << std::endl;
+        return false;
     }
+    return true;
 }
 
-double TrainSimulator::getCurrentSpeed() const {
-    if (train_controller_ptr) {
-        return train_controller_ptr->getCurrentState().velocity;
+void TrainSimulator::apply_pending_commands() {
+    ControlCommand command;
+    while (command_queue_.pop(command)) {
+        switch (command.type) {
+            case ControlCommand::Type::SET_MODE:
+                train_controller_ptr->setControlMode(static_cast<TrainController::ControlMode>(command.value));
+                break;
+            case ControlCommand::Type::SET_LEVEL:
+                train_controller_ptr->setControlLevel(static_cast<TrainController::ControlLevel>(command.value));
+                break;
+        }
+
+        const long long latency = ControlCommand::now_ns() - command.enqueue_time_ns;
+        last_command_latency_ns_.store(latency, std::memory_order_relaxed);
+        total_command_latency_ns_.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > max_command_latency_ns_.load(std::memory_order_relaxed)) {
+            max_command_latency_ns_.store(latency, std::memory_order_relaxed);
+        }
+        commands_applied_.fetch_add(1, std::memory_order_relaxed);
     }
-    return 0.0;
+}
+
+CommandLatencyStats TrainSimulator::getCommandLatencyStats() const {
+    CommandLatencyStats stats;
+    stats.applied_count = commands_applied_.load(std::memory_order_relaxed);
+    stats.dropped_count = commands_dropped_.load(std::memory_order_relaxed);
+    stats.last_latency_ns = last_command_latency_ns_.load(std::memory_order_relaxed);
+    stats.max_latency_ns = max_command_latency_ns_.load(std::memory_order_relaxed);
+    stats.total_latency_ns = total_command_latency_ns_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double TrainSimulator::getCurrentSpeed() const {
+    return published_state_.load().state.velocity;
 }
 
 double TrainSimulator::getSimulationTime() const {
@@ -221,17 +482,171 @@ double TrainSimulator::getSimulationTime() const {
     return static_cast<double>(current_simulation_time);
 }
 
-const KinematicState& TrainSimulator::getCurrentState() const {
-    if (train_controller_ptr) {
-        return train_controller_ptr->getCurrentState();
+UdpSendStats TrainSimulator::getSendStats() const {
+    return udp_comm.get_stats();
+}
+
+std::vector<DestinationStats> TrainSimulator::getDestinationStats() const {
+    return udp_comm.get_destination_stats();
+}
+
+bool TrainSimulator::add_destination(const std::string& ip, int port) {
+    if (start_sent_ || timer_running_) {
+        std::cerr << "警告：START 已发送，STOP 之前无法增加UDP目的地" << std::endl;
+        return false;
+    }
+    return udp_comm.add_destination(ip, port);
+}
+
+bool TrainSimulator::enable_feedback(int ack_timeout_ms) {
+    config_.ack_timeout_ms = ack_timeout_ms;
+    if (feedback_enabled_) {
+        return true;
+    }
+    const bool started = udp_comm.start_receiver(
+        [this](const NetworkFrameHeader&, const void* payload, size_t payload_size) {
+            feedback_.on_frame(payload, payload_size, MillisecondTimer::now_ns());
+        });
+    if (!started) {
+        std::cerr << "警告：无法启动UDP接收线程，模拟器回执不可用" << std::endl;
+        return false;
+    }
+    feedback_enabled_ = true;
+    return true;
+}
+
+bool TrainSimulator::start_capture(const std::string& path) {
+    if (timer_running_) {
+        std::cerr << "警告：仿真运行中，无法开始捕获" << std::endl;
+        return false;
+    }
+    try {
+        capture_ = std::make_shared<FrameCaptureWriter>(path);
+    } catch (const std::exception& e) {
+        std::cerr << "警告：" << e.what() << std::endl;
+        return false;
+    }
+    udp_comm.set_capture(capture_);
+    return true;
+}
+
+unsigned long long TrainSimulator::stop_capture() {
+    if (!capture_) {
+        return 0;
+    }
+    if (timer_running_) {
+        std::cerr << "警告：仿真运行中，无法停止捕获" << std::endl;
+        return 0;
+    }
+    udp_comm.set_capture(nullptr);
+    capture_->close();
+    const unsigned long long frames = capture_->frames_written();
+    if (capture_->frames_dropped() > 0 || capture_->failed()) {
+        std::cerr << "警告：捕获文件不完整（缓冲已满丢弃 " << capture_->frames_dropped() << " 帧"
+                  << (capture_->failed() ? "，写入失败" : "") << "）" << std::endl;
+    }
+    capture_.reset();
+    return frames;
+}
+
+FeedbackStats TrainSimulator::getFeedbackStats() const {
+    return feedback_.stats();
+}
+
+UdpReceiveStats TrainSimulator::getReceiveStats() const {
+    return udp_comm.get_receive_stats();
+}
+
+TimerStats TrainSimulator::getTimerStats() const {
+    return timer.get_stats();
+}
+
+bool TrainSimulator::configure_clock(ClockMode mode, double scale) {
+    if (start_sent_ || timer_running_) {
+        std::cerr << "警告：START 已发送，STOP 之前无法切换仿真时钟" << std::endl;
+        return false;
+    }
+    manual_clock_.reset();
+    switch (mode) {
+        case ClockMode::REAL:
+            clock_.reset();
+            break;
+        case ClockMode::SCALED:
+            if (!(scale > 0.0)) {
+                std::cerr << "警告：时钟倍率必须为正数" << std::endl;
+                return false;
+            }
+            clock_ = std::make_shared<ScaledClock>(scale);
+            break;
+        case ClockMode::MANUAL:
+            manual_clock_ = std::make_shared<ManualClock>();
+            clock_ = manual_clock_;
+            break;
+    }
+    config_.clock_mode = mode;
+    config_.clock_scale = scale;
+    timer.setClock(clock_);
+    return true;
+}
+
+bool TrainSimulator::advance_clock(double ms) {
+    if (!manual_clock_) {
+        return false;
+    }
+    manual_clock_->advance(static_cast<long long>(ms * 1e6));
+    return true;
+}
+
+LatencySummary TrainSimulator::getTickLatency(TickStage stage) const {
+    return tick_stats_.summary(stage);
+}
+
+KinematicState TrainSimulator::getCurrentState() const {
+    return published_state_.load().state;
+}
+
+StateSnapshot TrainSimulator::getStateSnapshot() const {
+    return published_state_.load();
+}
+
+SeqLockStats TrainSimulator::getSnapshotContention() const {
+    return published_state_.stats();
+}
+
+void TrainSimulator::publish_state(const KinematicState& state, unsigned long long tick) {
+    StateSnapshot snapshot;
+    snapshot.state = state;
+    snapshot.tick = tick;
+    snapshot.simulation_time_ms = static_cast<double>(simulation_start_time_)
+        + static_cast<double>(tick) * config_.SIMULATION_INTERVAL_MS;
+    published_state_.store(snapshot);
+}
+
+void TrainSimulator::prepare_realtime() {
+    if (Realtime::applyToCurrentThread(config_.realtime)) {
+        std::cout << "仿真线程已切换到实时执行配置" << std::endl;
+    }
+    Realtime::prefaultStack(config_.realtime.prefault_stack_bytes);
+    prefault_working_set();
+}
+
+void TrainSimulator::prefault_working_set() {
+    Realtime::prefault(this, sizeof(*this)); // 数据包暂存、直方图与状态快照
+
+    // 沿线路做一遍与周期内相同的插值，使样条系数与线路剖面所在页在首个周期前完成缺页
+    const double route_length = route.getTotalDistance();
+    const double step = std::max(route.getTrackProfile().step(), 1.0);
+    volatile double sink = 0.0;
+    for (double s = 0.0; s <= route_length; s += step) {
+        const ECEFPoint pos = route.getPositionAt(s);
+        const ECEFPoint jerk = route.getJerkAt(s, 1.0, 0.0, 0.0);
+        sink = sink + pos.x + jerk.x + route.getTrackProfile().at(s).grade;
     }
-    static const KinematicState empty_state = {};
-    return empty_state;
 }
 
 GeodeticPoint TrainSimulator::getCurrentPositionBLH() const {
-    if (train_controller_ptr && route.isInitialized()) {
-        const KinematicState state_1d = train_controller_ptr->getCurrentState();
+    if (route.isInitialized()) {
+        const KinematicState state_1d = published_state_.load().state;
         const ECEFPoint pos_3d_ecef = route.getPositionAt(state_1d.position);
         return GeoUtils::ecefToGeodetic(pos_3d_ecef);
     }
@@ -8,12 +8,23 @@
 #include "TrainCommunicator/UdpCommunicator.h"
 #include "TrainCommunicator/MillisecondTimer.h"
 #include "TrainCommunicator/Protocol.h"
+#include "TrainCommunicator/FrameCapture.h"
 #include "SimulatorConfiguration.h"
+#include "ControlCommandQueue.h"
+#include "StateSnapshot.h"
+#include "TickHistogram.h"
+#include "FeedbackTracker.h"
+#include "ConsistTrajectory.h"
+#include "TrajectoryTable.h"
+#include "ProducerConsumer.h"
 #include "TrajKit/GeoUtils.h"
 
 #include <array>
 #include <string>
+#include <vector>
 #include <memory>
+#include <atomic>
+#include <thread>
 
 #ifdef _WIN32
 #  ifdef TRAINSIMULATOR_EXPORTS
@@ -37,25 +48,127 @@ public:
 
     // --- 状态与模式控制 ---
     void print_current_status() const;
+    // 以下两个接口可在任意线程调用：指令进入无锁队列，由定时器线程在下一周期开始时执行；
+    // 仿真未运行时投递的指令在 run_simulation_non_blocking 启动定时器之前执行
     void set_control_mode(TrainController::ControlMode mode);
     void set_control_level(TrainController::ControlLevel level);
+    CommandLatencyStats getCommandLatencyStats() const;
 
-    const KinematicState& getCurrentState() const;
+    // 读取定时器线程最近一次发布的状态，可在任意线程调用且不会阻塞仿真周期
+    KinematicState getCurrentState() const;
+    StateSnapshot getStateSnapshot() const;
+    SeqLockStats getSnapshotContention() const;
 
     double getCurrentSpeed() const;
     // 新增：获取当前BLH坐标的函数
     GeodeticPoint getCurrentPositionBLH() const;
     double getSimulationTime () const;
+    TimerStats getTimerStats() const;
+    UdpSendStats getSendStats() const;
+    std::vector<DestinationStats> getDestinationStats() const;
+    // 增加一个UDP目的地，仅在 START 发出之前（或 STOP 之后）生效
+    bool add_destination(const std::string& ip, int port);
+
+    // --- 虚拟时钟 ---
+    // 切换仿真时钟，仅在 START 发出之前（或 STOP 之后）生效
+    bool configure_clock(ClockMode mode, double scale = 1.0);
+    // 手动时钟下推进虚拟时间，到期的周期随即在定时器线程中执行
+    bool advance_clock(double ms);
+    // 各阶段耗时直方图摘要（唤醒滞后、动力学、线路插值、发送、总耗时），可在任意线程调用
+    LatencySummary getTickLatency(TickStage stage) const;
+
+    // --- 模拟器回执 ---
+    // 启动接收线程；ack_timeout_ms 含义同 SimulatorConfiguration::ack_timeout_ms
+    bool enable_feedback(int ack_timeout_ms);
+    FeedbackStats getFeedbackStats() const;
+    UdpReceiveStats getReceiveStats() const;
+
+    // --- 发送帧捕获 ---
+    // 开始把之后发出的帧写入 path（覆盖），仅在定时器未运行时生效
+    bool start_capture(const std::string& path);
+    // 停止捕获并关闭文件，返回写入的帧数
+    unsigned long long stop_capture();
 
 private:
+    // 一个周期待发送的网络帧及其对应的状态；帧按线上格式原地填充后直接发送
+    struct PreparedPacket {
+        unsigned long long tick = 0;
+        KinematicState state;
+        TrajectoryFrame frame{}; // 只发送前 consist_.user_count() 个用户块
+        size_t frame_size = 0;
+    };
+
+    void on_tick();                // 定时器回调
+    // 推进动力学 advance_sec 秒并生成第 tick_index 周期的数据包
+    void prepare_packet(unsigned long long tick_index, double advance_sec, PreparedPacket& packet);
+    // 写入帧序号后发送
+    void send_packet(PreparedPacket& packet, long long tick_begin_ns);
+    void send_trajectory_frame(const unsigned char* frame, size_t frame_size, const KinematicState& state,
+                               unsigned long long tick, long long tick_begin_ns);
+
+    // 预计算轨迹表：在定时器启动前生成（或先生成首块），失败时返回 false 并退回实时计算
+    bool build_trajectory_table();
+    void fill_trajectory_table(unsigned long long first, unsigned long long last);
+    void stop_table_generator();
+    // 停止生成并把控制器推进到最后发出的记录，之后可回到实时计算
+    void finish_table_playback();
+    // 播放第 tick_index 周期的记录：只写入序号（超出表尾或生成超时时沿用已有记录并写入轨迹时间）
+    void send_table_record(unsigned long long tick_index, long long tick_begin_ns);
+
+    bool post_command(ControlCommand::Type type, int value);
+    void apply_pending_commands(); // 仅在定时器线程调用
+    void publish_state(const KinematicState& state, unsigned long long tick); // 仅在发送数据包的线程调用
+    void prepare_realtime();       // 在定时器线程首个周期前调用
+    void prefault_working_set();   // 预先触碰周期内访问的内存（与线程无关）
+
     long long simulation_start_time_;
 
     UdpCommunicator udp_comm;
     MillisecondTimer timer;
+    std::shared_ptr<SimClock> clock_;          // 为空时使用墙钟
+    std::shared_ptr<ManualClock> manual_clock_; // 手动时钟模式下与 clock_ 指向同一对象
+    std::atomic<bool> timer_running_{false};
+    std::atomic<bool> start_sent_{false}; // START 已发出且尚未发送 STOP
     Route route;
     std::unique_ptr<TrainController> train_controller_ptr;
     SimulatorConfiguration config_;
-    std::array<unsigned long long, 2> trajectory_sequence_numbers_;
+    // 编组用户（单/双用户配置也换算为编组）的轨迹换算，仅在生成数据包的线程使用
+    ConsistTrajectory consist_;
+
+    SeqLock<StateSnapshot> published_state_;
+    unsigned long long tick_count_ = 0; // 最近一次更新对应的定时器周期序号
+    TickInstrumentation tick_stats_;
+    FeedbackTracker feedback_;
+    std::atomic<bool> feedback_enabled_{false};
+    std::shared_ptr<FrameCaptureWriter> capture_;
+
+    // 预计算线程与定时器线程之间是单生产者/单消费者关系，使用有界无锁环形缓冲
+    static constexpr size_t MAX_PIPELINE_DEPTH = 16;
+    template<typename U>
+    using PipelineQueue = SpscRingBuffer<U, MAX_PIPELINE_DEPTH, WaitStrategy::FUTEX>;
+
+    PreparedPacket ready_packet_;      // 同步模式下定时器线程复用的数据包；流水线模式直接使用环形缓冲的槽位
+    std::unique_ptr<LookaheadPipeline<PreparedPacket, PipelineQueue>> packet_pipeline_;
+    unsigned long long pipeline_tick_ = 0; // 仅由预计算线程访问
+    unsigned long long frame_sequence_ = 0; // 已发出的轨迹帧数，仅由定时器线程访问
+    std::atomic<unsigned long long> pipeline_underruns_{0};
+
+    // 生成线程按周期顺序写入，定时器线程只读取已发布的记录
+    std::unique_ptr<TrajectoryTable> trajectory_table_;
+    std::unique_ptr<TrainController> table_controller_; // 发车状态的副本，仅由生成线程推进
+    std::thread table_generator_;
+    std::atomic<bool> table_generator_stop_{false};
+    std::atomic<bool> table_playback_{false};
+    unsigned long long table_played_ = 0; // 最近一次发出的记录，仅由定时器线程访问
+    std::atomic<unsigned long long> table_underruns_{0};
+    std::atomic<unsigned long long> table_repeats_{0};
+
+    ControlCommandQueue command_queue_;
+    std::atomic<unsigned long long> commands_applied_{0};
+    std::atomic<unsigned long long> commands_dropped_{0};
+    std::atomic<long long> last_command_latency_ns_{0};
+    std::atomic<long long> max_command_latency_ns_{0};
+    std::atomic<long long> total_command_latency_ns_{0};
 };
 
 #endif // TRAINSIMULATOR_H
@@ -0,0 +1,98 @@
+#include "TrajectoryTable.h"
+#include "TrainCommunicator/Protocol.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char TABLE_MAGIC[8] = {'T', 'R', 'N', 'T', 'A', 'B', '0', '1'};
+constexpr size_t RECORD_ALIGNMENT = 8;
+
+size_t align_up(size_t size) {
+    return (size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+} // namespace
+
+TrajectoryTable::TrajectoryTable(const std::string& path, unsigned long long tick_count, size_t user_count, int interval_ms)
+    : tick_count_(tick_count),
+      user_count_(user_count),
+      payload_offset_(NetworkFrameHeaderLayout::size),
+      frame_size_(NetworkFrameHeaderLayout::size + user_count * TrajectoryDataLayout::size),
+      record_size_(align_up(TrajectoryRecordHeaderLayout::size + frame_size_)) {
+    if (tick_count == 0 || user_count == 0 || user_count > MAX_CONSIST_USERS) {
+        throw std::runtime_error("轨迹表参数无效");
+    }
+    mapping_size_ = TrajectoryTableHeaderLayout::size + static_cast<size_t>(tick_count) * record_size_;
+
+    unsigned char* base = nullptr;
+#ifndef _WIN32
+    if (path.empty()) {
+        mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    } else {
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("无法创建轨迹表文件: " + path);
+        }
+        if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("无法扩展轨迹表文件: " + path);
+        }
+        mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+    }
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw std::runtime_error("轨迹表内存映射失败 (" + std::to_string(mapping_size_) + " 字节)");
+    }
+    // 生成与播放都按周期顺序访问
+    madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+    base = static_cast<unsigned char*>(mapping_);
+#else
+    (void)path;
+    storage_.assign(mapping_size_, 0);
+    base = storage_.data();
+#endif
+
+    TrajectoryTableHeader header{};
+    std::memcpy(header.magic, TABLE_MAGIC, sizeof(header.magic));
+    header.version = TRAJECTORY_TABLE_VERSION;
+    header.header_size = static_cast<uint32_t>(TrajectoryTableHeaderLayout::size);
+    header.user_count = static_cast<uint32_t>(user_count);
+    header.interval_ms = static_cast<uint32_t>(interval_ms);
+    header.tick_count = tick_count;
+    header.record_size = static_cast<uint32_t>(record_size_);
+    TrajectoryTableHeaderLayout::write(header, base);
+    records_ = base + TrajectoryTableHeaderLayout::size;
+}
+
+TrajectoryTable::~TrajectoryTable() {
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+    }
+#endif
+}
+
+KinematicState TrajectoryTable::state(unsigned long long tick) const {
+    const TrajectoryRecordHeader header = TrajectoryRecordHeaderLayout::read(record(tick));
+    KinematicState state;
+    state.position = header.position;
+    state.velocity = header.velocity;
+    state.acceleration = header.acceleration;
+    state.jerk = header.jerk;
+    return state;
+}
+
+void TrajectoryTable::set_state(unsigned long long tick, const KinematicState& state) {
+    TrajectoryRecordHeader header{};
+    header.position = state.position;
+    header.velocity = state.velocity;
+    header.acceleration = state.acceleration;
+    header.jerk = state.jerk;
+    TrajectoryRecordHeaderLayout::write(header, record(tick));
+}
@@ -0,0 +1,120 @@
+//
+// Created by fyh on 25-8-23.
+//
+
+#ifndef TRAJECTORYTABLE_H
+#define TRAJECTORYTABLE_H
+#pragma once
+
+#include "DynamicModel/KinematicState.h"
+#include "TrainCommunicator/WireLayout.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 轨迹数据来源
+enum class TrajectorySource {
+    LIVE,        // 每个周期实时推进动力学并做线路插值
+    PRECOMPUTED  // 启动前按确定性自动驾驶生成轨迹表，周期内只读取记录并写入序号
+};
+
+/**
+ * 轨迹表文件格式（小端，按 8 字节对齐）：
+ *
+ *   TrajectoryTableHeader (64B)
+ *   { TrajectoryRecordHeader (32B) + 网络帧（帧头 + 编组负载）+ 补齐到 8 字节 } × tick_count
+ *
+ * 第 k 条记录对应第 k 个周期（从 1 起），帧已按线上格式写好，序号字段在发送时写入。
+ */
+#pragma pack(push, 1)
+struct TrajectoryTableHeader {
+    char magic[8];            // "TRNTAB01"
+    uint32_t version;         // TRAJECTORY_TABLE_VERSION
+    uint32_t header_size;     // TrajectoryTableHeaderLayout::size
+    uint32_t user_count;
+    uint32_t interval_ms;
+    uint64_t tick_count;
+    uint32_t record_size;     // 含记录头与补齐
+    uint8_t reserved[28];
+};
+
+// 该周期的列车一维状态，播放时用于发布状态快照
+struct TrajectoryRecordHeader {
+    double position;
+    double velocity;
+    double acceleration;
+    double jerk;
+};
+#pragma pack(pop)
+
+using TrajectoryTableHeaderLayout = wire::Layout<TrajectoryTableHeader,
+    wire::Field<&TrajectoryTableHeader::magic>,
+    wire::Field<&TrajectoryTableHeader::version>,
+    wire::Field<&TrajectoryTableHeader::header_size>,
+    wire::Field<&TrajectoryTableHeader::user_count>,
+    wire::Field<&TrajectoryTableHeader::interval_ms>,
+    wire::Field<&TrajectoryTableHeader::tick_count>,
+    wire::Field<&TrajectoryTableHeader::record_size>,
+    wire::Reserved<28>>;
+
+using TrajectoryRecordHeaderLayout = wire::Layout<TrajectoryRecordHeader,
+    wire::Field<&TrajectoryRecordHeader::position>,
+    wire::Field<&TrajectoryRecordHeader::velocity>,
+    wire::Field<&TrajectoryRecordHeader::acceleration>,
+    wire::Field<&TrajectoryRecordHeader::jerk>>;
+
+static_assert(TrajectoryTableHeaderLayout::size == 64 && sizeof(TrajectoryTableHeader) == 64,
+              "TrajectoryTableHeader must be 64 bytes");
+static_assert(TrajectoryRecordHeaderLayout::size == 32, "TrajectoryRecordHeader must be 32 bytes");
+
+constexpr uint32_t TRAJECTORY_TABLE_VERSION = 1;
+
+/**
+ * @brief 预计算轨迹表：每个周期一条定长记录，保存在内存映射中。
+ *
+ * 给定路径时映射到该文件（可超出物理内存、事后可检查），否则使用匿名映射；非 POSIX 平台
+ * 始终使用进程内存。单个生成线程按周期顺序写入记录并以 publish 发布进度，播放线程只读取
+ * ready() 以内的记录，两者通过 ready 计数的 release/acquire 同步，无锁。
+ */
+class TrajectoryTable {
+public:
+    // 创建（覆盖）可容纳 tick_count 条记录的表，失败时抛出 std::runtime_error
+    TrajectoryTable(const std::string& path, unsigned long long tick_count, size_t user_count, int interval_ms);
+    ~TrajectoryTable();
+
+    TrajectoryTable(const TrajectoryTable&) = delete;
+    TrajectoryTable& operator=(const TrajectoryTable&) = delete;
+
+    unsigned long long tick_count() const { return tick_count_; }
+    size_t user_count() const { return user_count_; }
+    size_t frame_size() const { return frame_size_; }
+
+    // 第 tick 条记录（1 ≤ tick ≤ tick_count）的网络帧，帧头已写好
+    unsigned char* frame(unsigned long long tick) { return record(tick) + TrajectoryRecordHeaderLayout::size; }
+    unsigned char* payload(unsigned long long tick) { return frame(tick) + payload_offset_; }
+    KinematicState state(unsigned long long tick) const;
+    void set_state(unsigned long long tick, const KinematicState& state);
+
+    // 生成线程：前 ticks 条记录已完整写入
+    void publish(unsigned long long ticks) { ready_.store(ticks, std::memory_order_release); }
+    // 播放线程：可以安全读取的记录数
+    unsigned long long ready() const { return ready_.load(std::memory_order_acquire); }
+
+private:
+    unsigned char* record(unsigned long long tick) const { return records_ + (tick - 1) * record_size_; }
+
+    unsigned long long tick_count_;
+    size_t user_count_;
+    size_t payload_offset_;
+    size_t frame_size_;
+    size_t record_size_;
+    size_t mapping_size_ = 0;
+    void* mapping_ = nullptr;              // POSIX 下的映射
+    std::vector<unsigned char> storage_;   // 非 POSIX 平台的表内容
+    unsigned char* records_ = nullptr;
+    std::atomic<unsigned long long> ready_{0};
+};
+
+#endif //TRAJECTORYTABLE_H
@@ -0,0 +1,160 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// 当前线程所属的线程池及其队列下标，用于判断是否在工作线程内提交任务
+thread_local const WorkStealingPool* tls_pool = nullptr;
+thread_local size_t tls_index = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait_idle();
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_cond_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    const size_t index = (tls_pool == this) ? tls_index
+                                            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // 与工作线程的等待条件配对，避免丢失唤醒
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cond_.notify_one();
+}
+
+void WorkStealingPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cond_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::parallel_for(size_t begin, size_t end, const std::function<void(size_t)>& body, size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(1, grain);
+
+    std::atomic<size_t> remaining{(end - begin + grain - 1) / grain};
+    std::mutex done_mutex;
+    std::condition_variable done_cond;
+
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain) {
+        const size_t chunk_end = std::min(end, chunk_begin + grain);
+        submit([&, chunk_begin, chunk_end] {
+            for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                body(i);
+            }
+            // 计数在锁内递减，保证等待方返回时不再有任务访问这些局部同步对象
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                done_cond.notify_all();
+            }
+        });
+    }
+
+    // 在工作线程内调用时，一边等待一边帮忙执行任务，避免线程池自锁
+    if (tls_pool == this) {
+        std::function<void()> task;
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (try_pop_local(tls_index, task) || try_steal(tls_index, task)) {
+                task();
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(idle_mutex_);
+                    idle_cond_.notify_all();
+                }
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard<std::mutex> lock(done_mutex);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cond.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+    tls_pool = this;
+    tls_index = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (try_pop_local(index, task) || try_steal(index, task)) {
+            task();
+            task = nullptr;
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                idle_cond_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        if (stopping_) {
+            break;
+        }
+        wake_cond_.wait_for(lock, std::chrono::milliseconds(10), [this] {
+            return stopping_.load() || queued_.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping_) {
+            break;
+        }
+    }
+}
+
+bool WorkStealingPool::try_pop_local(size_t index, std::function<void()>& task) {
+    TaskQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::try_steal(size_t thief, std::function<void()>& task) {
+    const size_t count = queues_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        TaskQueue& victim = *queues_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
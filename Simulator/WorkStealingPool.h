@@ -0,0 +1,70 @@
+//
+// Created by fyh on 25-8-14.
+//
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 工作窃取线程池。
+ *
+ * 每个工作线程拥有自己的任务双端队列：本线程从队尾取任务，空闲线程从其他队列的队首窃取。
+ * 适合大量耗时不均的独立任务（例如批量离线仿真）。
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @param thread_count 工作线程数，0 表示使用硬件并发数
+     */
+    explicit WorkStealingPool(size_t thread_count = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 提交任务：在工作线程内提交时放入本线程队列，否则轮询分发
+    void submit(std::function<void()> task);
+
+    // 阻塞直到所有已提交的任务执行完毕
+    void wait_idle();
+
+    // 将 [begin, end) 切分为若干块并行执行 body(i)，返回前等待全部完成
+    void parallel_for(size_t begin, size_t end, const std::function<void(size_t)>& body, size_t grain = 1);
+
+    size_t thread_count() const { return workers_.size(); }
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void worker_loop(size_t index);
+    bool try_pop_local(size_t index, std::function<void()>& task);
+    bool try_steal(size_t thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<size_t> pending_{0}; // 已提交但尚未执行完的任务数
+    std::atomic<size_t> queued_{0};  // 仍在队列中等待执行的任务数
+    std::atomic<bool> stopping_{false};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cond_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cond_;
+};
+
+#endif //WORKSTEALINGPOOL_H
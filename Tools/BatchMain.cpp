@@ -0,0 +1,122 @@
+#include "Simulator/ScenarioBatch.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 用法: TrainBatch [-j threads=0] [-o output_dir=batch_out] [--no-trajectories] <scenario_file | @list_file>...
+// list_file 每行一个场景文件路径（相对路径以列表文件所在目录为基准）；汇总写入 output_dir/summary.csv
+namespace {
+void usage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [-j threads=0] [-o output_dir=batch_out] [--no-trajectories] <scenario_file | @list_file>..." << std::endl;
+}
+
+bool append_list(const std::string& list_file, std::vector<std::string>& paths) {
+    std::ifstream file(list_file);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::filesystem::path base = std::filesystem::path(list_file).parent_path();
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        line.erase(0, line.find_first_not_of(" \t"));
+        if (line.empty()) {
+            continue;
+        }
+        const std::filesystem::path path(line);
+        paths.push_back(path.is_relative() ? (base / path).lexically_normal().string() : line);
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t threads = 0;
+    ScenarioBatchOptions options;
+    options.output_dir = "batch_out";
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-o" && i + 1 < argc) {
+            options.output_dir = argv[++i];
+        } else if (arg == "--no-trajectories") {
+            options.write_trajectories = false;
+        } else if (arg.size() > 1 && arg[0] == '@') {
+            if (!append_list(arg.substr(1), paths)) {
+                std::cerr << "Failed to open scenario list: " << arg.substr(1) << std::endl;
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        // 解析失败的场景不运行，但仍在汇总中占一行
+        std::vector<Scenario> scenarios;
+        std::vector<ScenarioResult> parse_failures;
+        for (const std::string& path : paths) {
+            Scenario scenario;
+            std::string error;
+            if (Scenario::load(path, scenario, error)) {
+                scenarios.push_back(std::move(scenario));
+            } else {
+                std::cerr << path << ": " << error << std::endl;
+                ScenarioResult failed;
+                failed.name = std::filesystem::path(path).stem().string();
+                failed.source_file = path;
+                failed.error = error;
+                parse_failures.push_back(std::move(failed));
+            }
+        }
+
+        ScenarioBatch batch(options);
+        const auto wall_begin = std::chrono::steady_clock::now();
+        std::vector<ScenarioResult> results = batch.run(scenarios, threads);
+        const double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count();
+        for (const ScenarioResult& r : results) {
+            if (!r.ok) {
+                std::cerr << r.source_file << ": " << r.error << std::endl;
+            }
+        }
+        results.insert(results.end(), parse_failures.begin(), parse_failures.end());
+
+        std::filesystem::create_directories(options.output_dir);
+        const std::string summary_path = (std::filesystem::path(options.output_dir) / "summary.csv").string();
+        std::ofstream csv(summary_path);
+        ScenarioBatch::writeCsv(csv, results);
+
+        size_t ok = 0;
+        double simulated_seconds = 0.0;
+        for (const ScenarioResult& r : results) {
+            if (r.ok) {
+                ++ok;
+                simulated_seconds += r.simulated_time;
+            }
+        }
+        std::cout << "Scenarios: " << results.size() << " (ok " << ok << ", failed " << results.size() - ok << ")" << std::endl;
+        std::cout << "Summary written to " << summary_path << std::endl;
+        std::cout << "Wall time: " << wall_seconds << " s, simulated " << simulated_seconds << " s, speed-up over real time: "
+                  << (wall_seconds > 0.0 ? simulated_seconds / wall_seconds : 0.0) << "x" << std::endl;
+        return ok == results.size() ? 0 : 2;
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+        return 1;
+    }
+}
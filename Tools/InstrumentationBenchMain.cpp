@@ -0,0 +1,95 @@
+#include "Simulator/TickHistogram.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// 用法: TrainInstrumentationBench [ticks=1000000] [interval_ms=20]
+// 以与仿真周期相同的方式计时（5 次时钟读取 + 5 次直方图记录）包裹一段固定计算，
+// 与不计时的同一计算比较，给出每周期插桩开销及其占周期预算的比例
+namespace {
+constexpr int ROUNDS = 5;
+
+// 阻止编译器把模拟的周期计算整体消除
+volatile double g_sink;
+
+// 代替控制、线路与发送阶段的少量浮点计算
+double stage_work(double x) {
+    for (int i = 0; i < 16; ++i) {
+        x = std::sqrt(x * 1.0001 + 1.0);
+    }
+    return x;
+}
+
+double run_plain(unsigned long long ticks) {
+    double x = 1.0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned long long tick = 0; tick < ticks; ++tick) {
+        x = stage_work(x);
+        x = stage_work(x);
+        x = stage_work(x);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    g_sink = x;
+    return std::chrono::duration<double, std::nano>(elapsed).count();
+}
+
+// 与 TrainSimulator::on_tick 的计时点一一对应
+double run_instrumented(unsigned long long ticks, TickInstrumentation& stats) {
+    double x = 1.0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned long long tick = 0; tick < ticks; ++tick) {
+        const long long tick_begin_ns = MillisecondTimer::now_ns();
+        stats.record(TickStage::WAKE_LATENESS, 0);
+        const long long control_begin_ns = MillisecondTimer::now_ns();
+        x = stage_work(x);
+        const long long control_end_ns = MillisecondTimer::now_ns();
+        stats.record(TickStage::CONTROL, control_end_ns - control_begin_ns);
+        x = stage_work(x);
+        stats.record(TickStage::ROUTE, MillisecondTimer::now_ns() - control_end_ns);
+        const long long send_begin_ns = MillisecondTimer::now_ns();
+        x = stage_work(x);
+        const long long send_end_ns = MillisecondTimer::now_ns();
+        stats.record(TickStage::SEND, send_end_ns - send_begin_ns);
+        stats.record(TickStage::TOTAL, send_end_ns - tick_begin_ns);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    g_sink = x;
+    return std::chrono::duration<double, std::nano>(elapsed).count();
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const unsigned long long ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const double interval_ms = argc > 2 ? std::strtod(argv[2], nullptr) : 20.0;
+    if (ticks == 0 || interval_ms <= 0.0) {
+        std::cerr << "Usage: " << argv[0] << " [ticks=1000000] [interval_ms=20]" << std::endl;
+        return 1;
+    }
+
+    // 交替运行多轮，各取最快一轮
+    TickInstrumentation stats;
+    double plain_ns = 0.0;
+    double instrumented_ns = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        stats.reset();
+        const double plain = run_plain(ticks);
+        const double instrumented = run_instrumented(ticks, stats);
+        plain_ns = round == 0 ? plain : std::min(plain_ns, plain);
+        instrumented_ns = round == 0 ? instrumented : std::min(instrumented_ns, instrumented);
+    }
+
+    const double per_tick_plain = plain_ns / static_cast<double>(ticks);
+    const double per_tick_instrumented = instrumented_ns / static_cast<double>(ticks);
+    const double overhead = std::max(0.0, per_tick_instrumented - per_tick_plain);
+    std::cout << ticks << " ticks, best of " << ROUNDS << " rounds" << std::endl;
+    std::cout << "  tick work without instrumentation: " << per_tick_plain << " ns" << std::endl;
+    std::cout << "  tick work with instrumentation:    " << per_tick_instrumented << " ns" << std::endl;
+    std::cout << "  instrumentation overhead: " << overhead << " ns/tick = "
+              << overhead / (interval_ms * 1e6) * 100.0 << "% of a " << interval_ms << " ms tick" << std::endl;
+    std::cout << std::endl;
+    stats.print(std::cout);
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include "DynamicModel/MotionPlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// 用法: TrainPlannerBench [trains=1024] [ticks=20000]
+// 一个车队的规划器逐周期推进：比较特化内核（预选函数指针）与逐次按模式/档位分支的通用实现
+// 的每次更新开销，并确认两者轨迹一致
+namespace {
+constexpr double DT = 0.02;
+constexpr int ROUNDS = 5;
+
+/**
+ * @brief 特化前的通用规划器：每次更新按策略分支，并按档位下标取 Jerk 限制、现场做除法。
+ * 仅作对照基线，算法与 MotionPlanner 相同。
+ */
+class GenericPlanner {
+public:
+    explicit GenericPlanner(const MotionConstraints& constraints) : constraints_(constraints) {}
+
+    void setTargetVelocity(double v) { target_velocity_ = std::clamp(v, 0.0, constraints_.max_velocity); }
+    void setTargetAcceleration(double a) {
+        target_acceleration_ = std::clamp(a, constraints_.min_acceleration, constraints_.max_acceleration);
+    }
+    void setResistanceAcceleration(double a) { resistance_acceleration_ = a; }
+    void setJerkGear(int gear) { jerk_gear_ = std::clamp(gear, 0, 2); }
+
+    void update(ControlPolicy policy, double dt, KinematicState& state) {
+        switch (policy) {
+            case ControlPolicy::VELOCITY_TARGET: {
+                const double velocity_error = target_velocity_ - state.velocity;
+                const double time_to_stop_accel = state.acceleration / constraints_.max_jerk[jerk_gear_];
+                const double vel_change_to_stop_accel = 0.5 * state.acceleration * time_to_stop_accel;
+                double target_accel = 0.0;
+                if (std::abs(velocity_error) > std::abs(vel_change_to_stop_accel)) {
+                    target_accel = (velocity_error > 0) ? constraints_.max_acceleration : constraints_.min_acceleration;
+                }
+                const double target_applied = std::clamp(target_accel + resistance_acceleration_,
+                                                         constraints_.min_acceleration, constraints_.max_acceleration);
+                step(target_applied, dt, state);
+                break;
+            }
+            case ControlPolicy::ACCELERATION_TARGET:
+                step(target_acceleration_, dt, state);
+                if (state.velocity >= constraints_.max_velocity && state.acceleration > 0) {
+                    state.acceleration = 0;
+                    state.jerk = 0;
+                }
+                break;
+        }
+    }
+
+private:
+    void step(double target_applied, double dt, KinematicState& state) {
+        const double accel_error = target_applied - applied_acceleration_;
+        if (std::abs(accel_error) < constraints_.max_jerk[jerk_gear_] * dt) {
+            applied_acceleration_ = target_applied;
+            state.jerk = 0;
+        } else {
+            state.jerk = (accel_error > 0 ? 1.0 : -1.0) * constraints_.max_jerk[jerk_gear_];
+        }
+        state.acceleration = applied_acceleration_ - resistance_acceleration_;
+        state.position += state.velocity * dt + 0.5 * state.acceleration * dt * dt
+                          + (1.0 / 6.0) * state.jerk * dt * dt * dt;
+        state.velocity += state.acceleration * dt + 0.5 * state.jerk * dt * dt;
+        applied_acceleration_ += state.jerk * dt;
+        applied_acceleration_ = std::clamp(applied_acceleration_, constraints_.min_acceleration,
+                                           constraints_.max_acceleration);
+        state.acceleration = applied_acceleration_ - resistance_acceleration_;
+        state.velocity = std::clamp(state.velocity, 0.0, constraints_.max_velocity);
+        if (state.velocity <= 0.0 && state.acceleration < 0.0) {
+            state.acceleration = 0.0;
+            state.jerk = 0.0;
+        }
+    }
+
+    MotionConstraints constraints_;
+    double target_velocity_ = 0.0;
+    double target_acceleration_ = 0.0;
+    double resistance_acceleration_ = 0.0;
+    double applied_acceleration_ = 0.0;
+    int jerk_gear_ = 2;
+};
+
+// 与特化内核同样经由函数指针调用，只比较内核本身而非内联与否
+using GenericUpdate = void (*)(GenericPlanner& planner, ControlPolicy policy, double dt, KinematicState& state);
+
+void generic_update(GenericPlanner& planner, ControlPolicy policy, double dt, KinematicState& state) {
+    planner.update(policy, dt, state);
+}
+
+// 第 i 列车的运行设定：半数自动（目标速度），半数手动（目标加速度），档位轮换
+struct TrainSetup {
+    ControlPolicy policy;
+    int gear;
+    double target;
+    double resistance;
+};
+
+TrainSetup setup_of(size_t i) {
+    TrainSetup setup;
+    setup.policy = (i % 2 == 0) ? ControlPolicy::VELOCITY_TARGET : ControlPolicy::ACCELERATION_TARGET;
+    setup.gear = static_cast<int>(i % 3);
+    setup.target = setup.policy == ControlPolicy::VELOCITY_TARGET ? 5.0 + static_cast<double>(i % 20)
+                                                                   : 0.2 + 0.05 * static_cast<double>(i % 10);
+    setup.resistance = 0.01 + 0.001 * static_cast<double>(i % 7);
+    return setup;
+}
+
+// 中途改变目标，让各车经历加速、巡航和减速
+double target_at(const TrainSetup& setup, unsigned long long tick, unsigned long long ticks) {
+    if (tick < ticks / 2) {
+        return setup.target;
+    }
+    return setup.policy == ControlPolicy::VELOCITY_TARGET ? 0.5 * setup.target : -setup.target;
+}
+
+void apply_target(MotionPlanner& planner, const TrainSetup& setup, double target) {
+    if (setup.policy == ControlPolicy::VELOCITY_TARGET) {
+        planner.setTargetVelocity(target);
+    } else {
+        planner.setTargetAcceleration(target);
+    }
+}
+
+void apply_target(GenericPlanner& planner, const TrainSetup& setup, double target) {
+    if (setup.policy == ControlPolicy::VELOCITY_TARGET) {
+        planner.setTargetVelocity(target);
+    } else {
+        planner.setTargetAcceleration(target);
+    }
+}
+
+template<typename Planner>
+std::vector<Planner> make_fleet(size_t trains, const MotionConstraints& constraints) {
+    std::vector<Planner> planners;
+    planners.reserve(trains);
+    for (size_t i = 0; i < trains; ++i) {
+        const TrainSetup setup = setup_of(i);
+        planners.emplace_back(constraints);
+        planners.back().setJerkGear(setup.gear);
+        planners.back().setResistanceAcceleration(setup.resistance);
+        apply_target(planners.back(), setup, setup.target);
+    }
+    return planners;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// 特化内核：策略与档位只在设定改变时选择一次
+double run_specialized(const std::vector<TrainSetup>& setups, const MotionConstraints& constraints,
+                       unsigned long long ticks, std::vector<KinematicState>& states) {
+    const size_t trains = setups.size();
+    std::vector<MotionPlanner> planners = make_fleet<MotionPlanner>(trains, constraints);
+    std::vector<MotionPlanner::Kernel> kernels;
+    for (const TrainSetup& setup : setups) {
+        kernels.push_back(MotionPlanner::selectKernel(setup.policy));
+    }
+    states.assign(trains, KinematicState{});
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned long long tick = 0; tick < ticks; ++tick) {
+        if (tick == ticks / 2) {
+            for (size_t i = 0; i < trains; ++i) {
+                apply_target(planners[i], setups[i], target_at(setups[i], tick, ticks));
+            }
+        }
+        for (size_t i = 0; i < trains; ++i) {
+            kernels[i](planners[i], DT, states[i]);
+        }
+    }
+    return seconds_since(begin);
+}
+
+double run_generic(const std::vector<TrainSetup>& setups, const MotionConstraints& constraints,
+                   unsigned long long ticks, std::vector<KinematicState>& states) {
+    const size_t trains = setups.size();
+    std::vector<GenericPlanner> planners = make_fleet<GenericPlanner>(trains, constraints);
+    const std::vector<GenericUpdate> updaters(trains, &generic_update);
+    states.assign(trains, KinematicState{});
+    const auto begin = std::chrono::steady_clock::now();
+    for (unsigned long long tick = 0; tick < ticks; ++tick) {
+        if (tick == ticks / 2) {
+            for (size_t i = 0; i < trains; ++i) {
+                apply_target(planners[i], setups[i], target_at(setups[i], tick, ticks));
+            }
+        }
+        for (size_t i = 0; i < trains; ++i) {
+            updaters[i](planners[i], setups[i].policy, DT, states[i]);
+        }
+    }
+    return seconds_since(begin);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t trains = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    const unsigned long long ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    if (trains == 0 || ticks < 2) {
+        std::cerr << "Usage: " << argv[0] << " [trains=1024] [ticks=20000]" << std::endl;
+        return 1;
+    }
+
+    const MotionConstraints constraints;
+    std::vector<TrainSetup> setups;
+    for (size_t i = 0; i < trains; ++i) {
+        setups.push_back(setup_of(i));
+    }
+
+    // 两种实现交替运行多轮，各取最快一轮，减小调度与频率波动的影响
+    double specialized_seconds = 0.0;
+    double generic_seconds = 0.0;
+    std::vector<KinematicState> specialized_states;
+    std::vector<KinematicState> generic_states;
+    for (int round = 0; round < ROUNDS; ++round) {
+        const double s = run_specialized(setups, constraints, ticks, specialized_states);
+        const double g = run_generic(setups, constraints, ticks, generic_states);
+        specialized_seconds = round == 0 ? s : std::min(specialized_seconds, s);
+        generic_seconds = round == 0 ? g : std::min(generic_seconds, g);
+    }
+
+    // 特化内核只改变了常量的求值顺序，容许舍入级差异
+    double max_position_diff = 0.0;
+    double max_velocity_diff = 0.0;
+    for (size_t i = 0; i < trains; ++i) {
+        max_position_diff = std::max(max_position_diff,
+                                     std::abs(specialized_states[i].position - generic_states[i].position));
+        max_velocity_diff = std::max(max_velocity_diff,
+                                     std::abs(specialized_states[i].velocity - generic_states[i].velocity));
+    }
+
+    const double updates = static_cast<double>(trains) * static_cast<double>(ticks);
+    std::cout << trains << " trains x " << ticks << " ticks (" << updates << " updates), best of " << ROUNDS
+              << " rounds" << std::endl;
+    std::cout << "  specialized kernels: " << specialized_seconds * 1e9 / updates << " ns/update" << std::endl;
+    std::cout << "  generic switch:      " << generic_seconds * 1e9 / updates << " ns/update" << std::endl;
+    std::cout << "  speed-up: " << generic_seconds / specialized_seconds << "x" << std::endl;
+    std::cout << "  max final difference: position " << max_position_diff << " m, velocity " << max_velocity_diff
+              << " m/s" << std::endl;
+    return max_position_diff < 1e-3 && max_velocity_diff < 1e-6 ? 0 : 2;
+}
@@ -0,0 +1,92 @@
+#include "Simulator/ProducerConsumer.h"
+#include "Simulator/SpscRingBuffer.h"
+#include "Simulator/TickHistogram.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// 用法: TrainQueueBench [items=2000000] [paced_items=10000]
+// 比较 ThreadSafeQueue 与 SpscRingBuffer（各等待策略）的吞吐量，以及按固定节拍投递时
+// 从 push 到 pop 的单向延迟分布（元素携带投递时刻，两端使用同一单调时钟）
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto PACED_PERIOD = std::chrono::microseconds(100); // 与流水线按周期投递相同：生产者大部分时间空闲
+
+long long now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+template<typename Queue>
+double throughput_mops(long long items) {
+    Queue queue;
+    long long sum = 0;
+    const auto begin = Clock::now();
+    std::thread consumer([&] {
+        long long value = 0;
+        for (long long i = 0; i < items; ++i) {
+            queue.pop(value);
+            sum += value;
+        }
+    });
+    for (long long i = 0; i < items; ++i) {
+        queue.push(i);
+    }
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    if (sum != items * (items - 1) / 2) {
+        std::cerr << "Queue lost or duplicated elements" << std::endl;
+        std::exit(2);
+    }
+    return static_cast<double>(items) / seconds / 1e6;
+}
+
+template<typename Queue>
+LatencySummary paced_latency(long long items) {
+    Queue queue;
+    LatencyHistogram histogram;
+    std::thread consumer([&] {
+        long long sent_ns = 0;
+        for (long long i = 0; i < items; ++i) {
+            queue.pop(sent_ns);
+            histogram.record(now_ns() - sent_ns);
+        }
+    });
+    auto next = Clock::now();
+    for (long long i = 0; i < items; ++i) {
+        next += PACED_PERIOD;
+        std::this_thread::sleep_until(next);
+        queue.push(now_ns());
+    }
+    consumer.join();
+    return histogram.summary();
+}
+
+template<typename Queue>
+void run(const char* name, long long items, long long paced_items) {
+    const double mops = throughput_mops<Queue>(items);
+    const LatencySummary latency = paced_latency<Queue>(paced_items);
+    std::cout << "  " << name << ": " << mops << " Mops/s; push->pop p50 " << latency.p50_ns / 1000.0 << " us, p99 "
+              << latency.p99_ns / 1000.0 << " us, max " << latency.max_ns / 1000.0 << " us" << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const long long items = argc > 1 ? std::strtoll(argv[1], nullptr, 10) : 2000000;
+    const long long paced_items = argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 10000;
+    if (items <= 0 || paced_items <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [items=2000000] [paced_items=10000]" << std::endl;
+        return 1;
+    }
+
+    std::cout << items << " items back to back, " << paced_items << " items paced at 10 kHz" << std::endl;
+    run<ThreadSafeQueue<long long>>("ThreadSafeQueue     ", items, paced_items);
+    run<SpscRingBuffer<long long, 1024, WaitStrategy::FUTEX>>("SpscRingBuffer FUTEX", items, paced_items);
+    run<SpscRingBuffer<long long, 1024, WaitStrategy::YIELD>>("SpscRingBuffer YIELD", items, paced_items);
+    // 忙等只在两端各有独立核心时才有意义
+    if (std::thread::hardware_concurrency() > 1) {
+        run<SpscRingBuffer<long long, 1024, WaitStrategy::SPIN>>("SpscRingBuffer SPIN ", items, paced_items);
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Simulator/RealtimeProfile.h"
+#include "Simulator/TickHistogram.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// 用法: TrainRealtimeBench [seconds=10] [interval_ms=1] [load_threads=0] [cpu_core=-1]
+// 同一定时器先以普通线程、再以 RealtimeProfile（SCHED_FIFO、绑核、mlockall、预缺页栈）运行，
+// 比较触发滞后的分布；load_threads 个忙等线程用于制造 CPU 竞争。mlockall 作用于整个进程且不可撤销，
+// 因此普通线程一轮总是先运行
+namespace {
+// 忙等并不断改写一段内存，与定时器线程争用 CPU 与缓存
+void load_loop(const std::atomic<bool>& stop) {
+    std::vector<unsigned char> memory(8 << 20);
+    size_t offset = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        memory[offset] = static_cast<unsigned char>(memory[offset] + 1);
+        offset = (offset + 4096 + 64) % memory.size();
+    }
+}
+
+struct RunResult {
+    LatencySummary lateness;
+    TimerStats timer;
+    bool applied = true; // 实时配置是否全部生效
+};
+
+RunResult run(double seconds, int interval_ms, const RealtimeProfile* profile) {
+    RunResult result;
+    LatencyHistogram lateness;
+    MillisecondTimer timer;
+    timer.setInterval(interval_ms);
+    if (profile != nullptr) {
+        timer.setThreadInitializer([&result, profile]() {
+            result.applied = Realtime::applyToCurrentThread(*profile);
+            Realtime::prefaultStack(profile->prefault_stack_bytes);
+        });
+    }
+    timer.setCallback([&timer, &lateness]() { lateness.record(timer.get_last_lateness_ns()); });
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    timer.stop();
+    result.lateness = lateness.summary();
+    result.timer = timer.get_stats();
+    return result;
+}
+
+void print_run(const char* name, const RunResult& r) {
+    std::cout << "  " << name << ": ticks " << r.timer.ticks << ", overruns " << r.timer.overruns
+              << "; lateness p50 " << r.lateness.p50_ns / 1000.0 << " us, p99 " << r.lateness.p99_ns / 1000.0
+              << " us, p99.9 " << r.lateness.p999_ns / 1000.0 << " us, max " << r.lateness.max_ns / 1000.0 << " us";
+    if (!r.applied) {
+        std::cout << " (realtime settings not fully applied)";
+    }
+    std::cout << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 10.0;
+    const int interval_ms = argc > 2 ? std::atoi(argv[2]) : 1;
+    const int load_threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    const int cpu_core = argc > 4 ? std::atoi(argv[4]) : -1;
+    if (seconds <= 0.0 || interval_ms <= 0 || load_threads < 0) {
+        std::cerr << "Usage: " << argv[0] << " [seconds=10] [interval_ms=1] [load_threads=0] [cpu_core=-1]" << std::endl;
+        return 1;
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> load;
+    for (int i = 0; i < load_threads; ++i) {
+        load.emplace_back(load_loop, std::cref(stop));
+    }
+
+    RealtimeProfile profile;
+    profile.enabled = true;
+    profile.cpu_core = cpu_core;
+    const RunResult normal = run(seconds, interval_ms, nullptr);
+    const RunResult realtime = run(seconds, interval_ms, &profile);
+
+    stop = true;
+    for (std::thread& thread : load) {
+        thread.join();
+    }
+
+    std::cout << seconds << " s per run at " << interval_ms << " ms, " << load_threads << " load threads, "
+              << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    print_run("normal thread  ", normal);
+    print_run("RealtimeProfile", realtime);
+    return 0;
+}
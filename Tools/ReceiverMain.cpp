@@ -0,0 +1,50 @@
+#include "Simulator/LoopbackReceiver.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// 用法: TrainReceiver [port=9988] [duration_s=0] [bind_ip=127.0.0.1] [feedback_every=0]
+// duration_s 为 0 时一直运行到收到 STOP 指令；feedback_every > 0 时同时回复指令应答与数据流反馈
+int main(int argc, char* argv[]) {
+    LoopbackReceiverOptions options;
+    if (argc > 1) options.port = std::atoi(argv[1]);
+    const double duration_s = argc > 2 ? std::atof(argv[2]) : 0.0;
+    if (argc > 3) options.bind_ip = argv[3];
+    if (argc > 4) {
+        options.feedback_every = static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10));
+        options.ack_commands = options.feedback_every > 0;
+    }
+    options.receive_buffer_bytes = 4 * 1024 * 1024;
+
+    try {
+        LoopbackReceiver receiver(options);
+        receiver.start();
+        std::cout << "Listening on " << options.bind_ip << ":" << receiver.port()
+                  << (duration_s > 0.0 ? " for " + std::to_string(duration_s) + " s" : " until STOP") << std::endl;
+
+        // 每秒输出一次进度
+        const auto begin = std::chrono::steady_clock::now();
+        bool stopped = false;
+        while (!stopped) {
+            stopped = receiver.wait_for_stop(1000);
+            const StreamReport progress = receiver.report();
+            std::cout << "frames " << progress.trajectory_frames << ", " << progress.frames_per_sec << " frames/s, jitter p99 "
+                      << progress.jitter.p99_ns / 1000.0 << " us" << std::endl;
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            if (duration_s > 0.0 && elapsed >= duration_s) {
+                break;
+            }
+        }
+        receiver.stop();
+
+        const StreamReport report = receiver.report();
+        report.print(std::cout);
+        std::cout << (report.clean() ? "Stream OK" : "Stream has errors") << std::endl;
+        return report.clean() ? 0 : 2;
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+        return 1;
+    }
+}
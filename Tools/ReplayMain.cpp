@@ -0,0 +1,64 @@
+#include "Simulator/FrameReplay.h"
+#include "Simulator/StreamValidator.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// 用法: TrainReplay <capture_file> <ip> <port> [rate_scale=1] [spin_us=50]
+// rate_scale 为 0 时不等待，按最快速度发送
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <capture_file> <ip> <port> [rate_scale=1] [spin_us=50]" << std::endl;
+        return 1;
+    }
+
+    try {
+        FrameCaptureReader capture;
+        if (!capture.open(argv[1])) {
+            std::cerr << "Failed to open capture: " << argv[1] << std::endl;
+            return 1;
+        }
+        const auto& frames = capture.frames();
+        std::cout << "Loaded " << frames.size() << " frames";
+        if (frames.size() > 1) {
+            std::cout << " spanning " << (frames.back().timestamp_ns - frames.front().timestamp_ns) / 1e9 << " s";
+        }
+        std::cout << (capture.truncated() ? " (truncated tail ignored)" : "") << std::endl;
+
+        // 按与接收端相同的线上布局检查捕获内容，格式错误只提示不阻止回放
+        StreamValidator validator;
+        for (const CapturedFrame& frame : frames) {
+            validator.on_datagram(frame.data, frame.size, frame.timestamp_ns);
+        }
+        const StreamReport content = validator.report();
+        std::cout << "Capture content: " << content.start_commands << " start, " << content.trajectory_frames
+                  << " trajectory, " << content.stop_commands << " stop";
+        if (content.bad_header + content.bad_payload > 0) {
+            std::cout << ", " << content.bad_header + content.bad_payload << " malformed";
+        }
+        std::cout << std::endl;
+
+        ReplayOptions options;
+        if (argc > 4) options.rate_scale = std::atof(argv[4]);
+        if (argc > 5) options.spin_window_ns = std::atoll(argv[5]) * 1000;
+
+        UdpCommunicator udp(argv[2], std::atoi(argv[3]));
+        FrameReplayer replayer(capture);
+        const ReplayReport report = replayer.replay(udp, options);
+
+        if (report.frames_skipped > 0) {
+            std::cout << "Skipped " << report.frames_skipped << " frames that failed to send during capture" << std::endl;
+        }
+        std::cout << "Sent " << report.frames_sent << " frames (" << report.send_failures << " failures) in "
+                  << report.duration_sec << " s, " << report.frames_per_sec << " frames/s" << std::endl;
+        if (report.lateness.count > 0) {
+            std::cout << "Lateness (us): mean " << report.lateness.mean_ns / 1000.0 << " p50 " << report.lateness.p50_ns / 1000.0
+                      << " p99 " << report.lateness.p99_ns / 1000.0 << " p99.9 " << report.lateness.p999_ns / 1000.0
+                      << " max " << report.lateness.max_ns / 1000.0 << std::endl;
+        }
+        return report.send_failures == 0 ? 0 : 2;
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,122 @@
+#include "Simulator/TickHistogram.h"
+#include "TrainCommunicator/MillisecondTimer.h"
+#include "TrainCommunicator/Protocol.h"
+#include "TrainCommunicator/UdpCommunicator.h"
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// 用法: TrainSendBench [frames=1000000] [destinations=1]
+// 向本机丢弃端口发送双用户轨迹帧，比较各发送后端的发送速率、每百万帧的 CPU 时间与单次发送耗时分布
+namespace {
+#ifndef _WIN32
+// 绑定到本机任意端口且从不读取的接收 socket；接收缓冲满后内核丢弃报文，发送端不受影响
+struct SinkSocket {
+    int fd = -1;
+    int port = 0;
+
+    SinkSocket() {
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (fd >= 0 && bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0
+            && getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+            port = ntohs(addr.sin_port);
+        }
+    }
+    ~SinkSocket() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+double cpu_seconds(clockid_t clock) {
+    timespec ts{};
+    clock_gettime(clock, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+#endif
+} // namespace
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    std::cerr << "TrainSendBench requires a POSIX platform" << std::endl;
+    return 1;
+#else
+    const size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const size_t destination_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+    if (frames == 0 || destination_count == 0) {
+        std::cerr << "Usage: " << argv[0] << " [frames=1000000] [destinations=1]" << std::endl;
+        return 1;
+    }
+
+    std::vector<SinkSocket> sinks(destination_count);
+    for (const SinkSocket& sink : sinks) {
+        if (sink.port == 0) {
+            std::cerr << "Failed to bind sink socket" << std::endl;
+            return 1;
+        }
+    }
+    DualTrajectoryData payload{};
+
+    std::cout << frames << " frames x " << destination_count << " destinations, "
+              << sizeof(payload) + NetworkFrameHeaderLayout::size << " B per datagram" << std::endl;
+    std::cout << std::left << std::setw(18) << "backend" << std::right << std::setw(12) << "frames/s"
+              << std::setw(14) << "thread cpu" << std::setw(14) << "process cpu" << std::setw(10) << "failures"
+              << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+              << "   (cpu in s per million frames)" << std::endl;
+
+    for (const SendBackend backend : {SendBackend::SENDMSG, SendBackend::IO_URING, SendBackend::IO_URING_SQPOLL}) {
+        UdpCommunicator udp("127.0.0.1", sinks[0].port);
+        for (size_t i = 1; i < sinks.size(); ++i) {
+            udp.add_destination("127.0.0.1", sinks[i].port);
+        }
+        if (!udp.set_send_backend(backend)) {
+            std::cout << std::left << std::setw(18) << send_backend_name(backend) << "unavailable" << std::endl;
+            continue;
+        }
+
+        // 进程 CPU 包含 SQPOLL 内核线程，线程 CPU 只包含发送线程自身
+        const double thread_begin = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+        const double process_begin = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+        // 逐次计时的两次时钟读取约几十纳秒，计入发送速率
+        LatencyHistogram send_latency;
+        const auto wall_begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < frames; ++i) {
+            payload.user1.trajectory_data_seq_num = i + 1;
+            const long long send_begin_ns = MillisecondTimer::now_ns();
+            udp.send(&payload, sizeof(payload));
+            send_latency.record(MillisecondTimer::now_ns() - send_begin_ns);
+        }
+        udp.flush_sends();
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count();
+        const double thread_cpu = cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - thread_begin;
+        const double process_cpu = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID) - process_begin;
+        const double per_million = 1e6 / static_cast<double>(frames);
+        const LatencySummary latency = send_latency.summary();
+
+        std::cout << std::left << std::setw(18) << send_backend_name(backend) << std::right << std::fixed
+                  << std::setprecision(0) << std::setw(12) << static_cast<double>(frames) / wall
+                  << std::setprecision(3) << std::setw(14) << thread_cpu * per_million
+                  << std::setw(14) << process_cpu * per_million
+                  << std::setw(10) << udp.get_stats().failures << std::setprecision(2)
+                  << std::setw(10) << latency.p50_ns / 1000.0 << std::setw(10) << latency.p99_ns / 1000.0
+                  << std::setw(10) << latency.max_ns / 1000.0 << std::endl;
+    }
+    return 0;
+#endif
+}
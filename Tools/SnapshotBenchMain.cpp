@@ -0,0 +1,135 @@
+#include "Simulator/StateSnapshot.h"
+#include "Simulator/TickHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// 用法: TrainSnapshotBench [seconds=5] [writer_hz=50]
+// 写者按 writer_hz 发布状态快照（0 表示不限速，作为最坏情况），读者以 10 kHz 轮询；
+// 报告读者重试率、读/写延迟分布，并逐次检查快照是否撕裂（各字段由同一周期号推出）
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr auto READER_PERIOD = std::chrono::microseconds(100); // 10 kHz
+
+// 所有字段都由 tick 决定，读到的组合不一致即为撕裂
+StateSnapshot make_snapshot(unsigned long long tick) {
+    StateSnapshot snapshot;
+    snapshot.tick = tick;
+    snapshot.state.position = 0.5 * static_cast<double>(tick);
+    snapshot.state.velocity = static_cast<double>(tick % 97);
+    snapshot.state.acceleration = -static_cast<double>(tick);
+    snapshot.state.jerk = static_cast<double>(tick & 0xFF);
+    snapshot.simulation_time_ms = 20.0 * static_cast<double>(tick);
+    return snapshot;
+}
+
+bool consistent(const StateSnapshot& snapshot) {
+    const StateSnapshot expected = make_snapshot(snapshot.tick);
+    return snapshot.state.position == expected.state.position
+           && snapshot.state.velocity == expected.state.velocity
+           && snapshot.state.acceleration == expected.state.acceleration
+           && snapshot.state.jerk == expected.state.jerk
+           && snapshot.simulation_time_ms == expected.simulation_time_ms;
+}
+
+long long elapsed_ns(Clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+}
+
+struct RunResult {
+    SeqLockStats stats;
+    unsigned long long torn = 0;
+    unsigned long long writes = 0;
+    LatencySummary load;
+    LatencySummary store;
+};
+
+RunResult run(double seconds, double writer_hz, bool with_reader) {
+    SeqLock<StateSnapshot> lock;
+    LatencyHistogram load_hist;
+    LatencyHistogram store_hist;
+    std::atomic<bool> stop{false};
+    unsigned long long writes = 0;
+    unsigned long long torn = 0;
+
+    std::thread writer([&] {
+        const auto period = writer_hz > 0.0
+                                ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / writer_hz))
+                                : Clock::duration::zero();
+        auto next = Clock::now();
+        while (!stop.load(std::memory_order_relaxed)) {
+            const StateSnapshot snapshot = make_snapshot(++writes);
+            const auto begin = Clock::now();
+            lock.store(snapshot);
+            store_hist.record(elapsed_ns(begin));
+            if (period != Clock::duration::zero()) {
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+        }
+    });
+
+    std::thread reader;
+    if (with_reader) {
+        reader = std::thread([&] {
+            auto next = Clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto begin = Clock::now();
+                const StateSnapshot snapshot = lock.load();
+                load_hist.record(elapsed_ns(begin));
+                if (!consistent(snapshot)) {
+                    ++torn;
+                }
+                next += READER_PERIOD;
+                std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    writer.join();
+    if (reader.joinable()) {
+        reader.join();
+    }
+    return {lock.stats(), torn, writes, load_hist.summary(), store_hist.summary()};
+}
+
+void print_latency(const char* name, const LatencySummary& s) {
+    std::cout << "  " << name << ": p50 " << s.p50_ns << " ns, p99 " << s.p99_ns << " ns, p99.9 " << s.p999_ns
+              << " ns, max " << s.max_ns << " ns" << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 5.0;
+    const double writer_hz = argc > 2 ? std::strtod(argv[2], nullptr) : 50.0;
+    if (seconds <= 0.0 || writer_hz < 0.0) {
+        std::cerr << "Usage: " << argv[0] << " [seconds=5] [writer_hz=50]" << std::endl;
+        return 1;
+    }
+
+    const RunResult alone = run(seconds, writer_hz, false);
+    const RunResult contended = run(seconds, writer_hz, true);
+
+    const double retry_rate = contended.stats.reads != 0
+                                  ? static_cast<double>(contended.stats.retries) / static_cast<double>(contended.stats.reads)
+                                  : 0.0;
+    std::cout << "Writer ";
+    if (writer_hz > 0.0) {
+        std::cout << writer_hz << " Hz";
+    } else {
+        std::cout << "unthrottled";
+    }
+    std::cout << ", reader 10 kHz, " << seconds << " s" << std::endl;
+    std::cout << "  writes " << contended.writes << ", reads " << contended.stats.reads << ", retries "
+              << contended.stats.retries << " (" << retry_rate * 100.0 << "% of reads), torn " << contended.torn
+              << std::endl;
+    print_latency("reader load       ", contended.load);
+    print_latency("writer store      ", contended.store);
+    print_latency("writer (no reader)", alone.store);
+    return contended.torn == 0 ? 0 : 2;
+}
@@ -0,0 +1,65 @@
+#include "Simulator/ParameterSweep.h"
+#include "TrajKit/Route.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// 用法: TrainSweep <route_file> [runs=1000] [seed=1] [threads=0] [output_csv]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <route_file> [runs=1000] [seed=1] [threads=0] [output_csv]" << std::endl;
+        return 1;
+    }
+
+    try {
+        Route route;
+        if (!route.loadFromFile(argv[1])) {
+            std::cerr << "Failed to load route: " << argv[1] << std::endl;
+            return 1;
+        }
+
+        SweepSpec spec;
+        spec.base_vehicle.trainType = L"SweepTrain";
+        spec.base_vehicle.maxSpeed = 120.0;
+        spec.base_vehicle.trainLong = 200.0;
+        spec.base_vehicle.resistanceCoefficients[0] = 2.28;
+        spec.base_vehicle.resistanceCoefficients[1] = 0.0293;
+        spec.base_vehicle.resistanceCoefficients[2] = 0.000178;
+        spec.base_vehicle.tractionAcceleration = 0.6;
+        spec.base_vehicle.brakingAcceleration = -0.9;
+        if (argc > 2) spec.runs = std::strtoull(argv[2], nullptr, 10);
+        if (argc > 3) spec.seed = std::strtoull(argv[3], nullptr, 10);
+        const size_t threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+
+        ParameterSweep sweep(route, spec);
+        const auto wall_begin = std::chrono::steady_clock::now();
+        const auto results = sweep.run(threads);
+        const double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_begin).count();
+        const SweepSummary summary = ParameterSweep::summarize(results);
+
+        if (argc > 5) {
+            std::ofstream csv(argv[5]);
+            ParameterSweep::writeCsv(csv, results);
+            std::cout << "Per-run results written to " << argv[5] << std::endl;
+        }
+
+        double simulated_seconds = 0.0;
+        for (const auto& r : results) simulated_seconds += r.run_time;
+
+        auto print_metric = [](const char* name, const SweepMetricSummary& m) {
+            std::cout << name << ": mean=" << m.mean << " min=" << m.min << " max=" << m.max << " p95=" << m.p95 << std::endl;
+        };
+        std::cout << "Runs: " << summary.runs << " (completed " << summary.completed << ")" << std::endl;
+        print_metric("Run time (s)", summary.run_time);
+        print_metric("Stop error (m)", summary.stop_error);
+        print_metric("Max jerk (m/s^3)", summary.max_jerk);
+        std::cout << "Wall time: " << wall_seconds << " s, speed-up over real time: "
+                  << (wall_seconds > 0.0 ? simulated_seconds / wall_seconds : 0.0) << "x" << std::endl;
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "Simulator/TrainSimulator.h"
+#include "TrainCommunicator/FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// 用法: TrainTableBench <route_file> [seconds=120] [cars=0] [chunk_ticks=500]
+// 以手动时钟逐周期驱动同一列车，分别用实时计算、整表预计算与分块预计算发出轨迹帧；比较周期内各阶段
+// 耗时与启动耗时，并逐帧确认三种方式发出的帧（含序号）完全一致。cars=0 时为双用户配置。
+// 仿真器本身逐周期向标准输出打印列车状态，结果写到标准错误
+namespace {
+constexpr int INTERVAL_MS = 20;
+
+struct RunResult {
+    double startup_ms = 0.0;    // run_simulation_non_blocking 耗时，预计算时包含生成（首块）
+    LatencySummary control;
+    LatencySummary route;
+    LatencySummary total;
+};
+
+SimulatorConfiguration make_config(const std::filesystem::path& route_file, int seconds, int cars) {
+    SimulatorConfiguration config{};
+    config.test_vehicle = TrainInfo{L"TableBench", 120.0, 200.0, {2.28, 0.0293, 0.000178}, 0.6, -0.9};
+    config.route_file = route_file.wstring();
+    config.ip = L"127.0.0.1";
+    config.port = 9; // discard
+    config.SIMULATION_INTERVAL_MS = INTERVAL_MS;
+    config.simulation_duration = static_cast<long long>(seconds) * 1000;
+    config.clock_mode = ClockMode::MANUAL;
+    if (cars > 0) {
+        config.consist_users = make_per_car_consist(cars, config.test_vehicle.trainLong, 1);
+    } else {
+        config.enable_second_user = true;
+    }
+    return config;
+}
+
+RunResult run(SimulatorConfiguration config, TrajectorySource source, int chunk_ticks,
+              const std::filesystem::path& capture_file, unsigned long long ticks) {
+    config.trajectory_source = source;
+    config.precompute_chunk_ticks = chunk_ticks;
+    config.capture_file = capture_file.wstring();
+
+    TrainSimulator simulator(config);
+    simulator.start_simulation();
+    RunResult result;
+    const auto begin = std::chrono::steady_clock::now();
+    simulator.run_simulation_non_blocking();
+    result.startup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    // 每次只推进一个周期并等它发出，各方式发出的周期完全相同
+    for (unsigned long long tick = 1; tick <= ticks; ++tick) {
+        simulator.advance_clock(INTERVAL_MS);
+        while (simulator.getStateSnapshot().tick < tick) {
+            std::this_thread::yield();
+        }
+    }
+    result.control = simulator.getTickLatency(TickStage::CONTROL);
+    result.route = simulator.getTickLatency(TickStage::ROUTE);
+    result.total = simulator.getTickLatency(TickStage::TOTAL);
+    simulator.stop_simulation();
+    simulator.stop_capture();
+    return result;
+}
+
+// 返回内容不同（或数量不同）的帧数
+size_t compare_captures(const std::filesystem::path& a_file, const std::filesystem::path& b_file) {
+    FrameCaptureReader a;
+    FrameCaptureReader b;
+    if (!a.open(a_file.string()) || !b.open(b_file.string())) {
+        std::cerr << "Failed to read captures " << a_file << ", " << b_file << std::endl;
+        std::exit(1);
+    }
+    const size_t count = std::min(a.frames().size(), b.frames().size());
+    size_t different = std::max(a.frames().size(), b.frames().size()) - count;
+    for (size_t i = 0; i < count; ++i) {
+        const CapturedFrame& x = a.frames()[i];
+        const CapturedFrame& y = b.frames()[i];
+        if (x.size != y.size || std::memcmp(x.data, y.data, x.size) != 0) {
+            ++different;
+        }
+    }
+    return different;
+}
+
+void print_run(const char* name, const RunResult& r) {
+    std::cerr << "  " << name << ": startup " << r.startup_ms << " ms; control mean " << r.control.mean_ns / 1000.0
+              << " us, route/read mean " << r.route.mean_ns / 1000.0 << " us, p99 " << r.route.p99_ns / 1000.0
+              << " us; tick total p50 " << r.total.p50_ns / 1000.0 << " us, p99 " << r.total.p99_ns / 1000.0
+              << " us, max " << r.total.max_ns / 1000.0 << " us" << std::endl;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int seconds = argc > 2 ? std::atoi(argv[2]) : 120;
+    const int cars = argc > 3 ? std::atoi(argv[3]) : 0;
+    const int chunk_ticks = argc > 4 ? std::atoi(argv[4]) : 500;
+    if (argc < 2 || seconds <= 0 || cars < 0 || chunk_ticks <= 0) {
+        std::cerr << "Usage: " << argv[0] << " <route_file> [seconds=120] [cars=0] [chunk_ticks=500]" << std::endl;
+        return 1;
+    }
+
+    try {
+        const SimulatorConfiguration config = make_config(argv[1], seconds, cars);
+        const unsigned long long ticks = static_cast<unsigned long long>(seconds) * 1000 / INTERVAL_MS;
+        const std::filesystem::path dir = std::filesystem::temp_directory_path();
+        const std::filesystem::path live_file = dir / "train_table_bench_live.cap";
+        const std::filesystem::path table_file = dir / "train_table_bench_table.cap";
+        const std::filesystem::path chunked_file = dir / "train_table_bench_chunked.cap";
+
+        const RunResult live = run(config, TrajectorySource::LIVE, 0, live_file, ticks);
+        const RunResult table = run(config, TrajectorySource::PRECOMPUTED, 0, table_file, ticks);
+        const RunResult chunked = run(config, TrajectorySource::PRECOMPUTED, chunk_ticks, chunked_file, ticks);
+        const size_t table_diff = compare_captures(live_file, table_file);
+        const size_t chunked_diff = compare_captures(live_file, chunked_file);
+        std::filesystem::remove(live_file);
+        std::filesystem::remove(table_file);
+        std::filesystem::remove(chunked_file);
+
+        std::cerr << std::endl << ticks << " ticks of " << INTERVAL_MS << " ms, "
+                  << (cars > 0 ? std::to_string(cars) + " cars" : std::string("two users")) << std::endl;
+        print_run("live        ", live);
+        print_run("table       ", table);
+        print_run("table chunks", chunked);
+        std::cerr << "  frames differing from live: table " << table_diff << ", chunked " << chunked_diff << std::endl;
+        return table_diff == 0 && chunked_diff == 0 ? 0 : 2;
+    } catch (const std::exception& ex) {
+        std::cerr << "Exception: " << ex.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+#include "TrainCommunicator/Protocol.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// 用法: TrainWireBench [iterations=2000000]
+// 比较线上布局序列化与整体 memcpy 打包结构体的开销，并确认两者产生相同字节
+namespace {
+constexpr size_t BATCH = 64;
+
+TrajectoryData make_sample(size_t i) {
+    TrajectoryData data{};
+    data.trajectory_type = 1;
+    data.trajectory_id = static_cast<unsigned int>(i % 7);
+    data.trajectory_data_seq_num = i;
+    data.trajectory_time = 0.001 * static_cast<double>(i);
+    data.user_pos_x = -2148744.125 + static_cast<double>(i);
+    data.user_pos_y = 4426641.5;
+    data.user_pos_z = 4044655.75 - static_cast<double>(i);
+    data.user_vel_x = 12.5;
+    data.carrier_roll = 0.01;
+    data.carrier_azimuth = 1.2;
+    data.carrier_pitch = -0.003;
+    return data;
+}
+
+// 阻止编译器把未被读取的输出整体消除
+volatile unsigned char g_sink;
+
+template<typename Fn>
+double ns_per_op(size_t iterations, Fn&& fn) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    std::vector<TrajectoryData> samples;
+    for (size_t i = 0; i < BATCH; ++i) {
+        samples.push_back(make_sample(i));
+    }
+    std::vector<unsigned char> by_layout(BATCH * TrajectoryDataLayout::size);
+    std::vector<unsigned char> by_memcpy(BATCH * sizeof(TrajectoryData));
+
+    // 小端主机上两种方式的字节必须一致，且读回后逐字段相同
+    for (size_t i = 0; i < BATCH; ++i) {
+        TrajectoryDataLayout::write(samples[i], by_layout.data() + i * TrajectoryDataLayout::size);
+        std::memcpy(by_memcpy.data() + i * sizeof(TrajectoryData), &samples[i], sizeof(TrajectoryData));
+    }
+    if (by_layout != by_memcpy) {
+        std::cerr << "Layout bytes differ from packed struct bytes" << std::endl;
+        return 2;
+    }
+    for (size_t i = 0; i < BATCH; ++i) {
+        const TrajectoryData back = TrajectoryDataLayout::read(by_layout.data() + i * TrajectoryDataLayout::size);
+        if (std::memcmp(&back, &samples[i], sizeof(TrajectoryData)) != 0) {
+            std::cerr << "Layout round trip mismatch at " << i << std::endl;
+            return 2;
+        }
+    }
+
+    StartCommand start{};
+    start.command_word = COMMAND_START_DUAL;
+    start.data_length = static_cast<uint32_t>(start_command_size(2));
+    start.simulation_start_time = 123456789;
+    start.users[0].trajectory_id = 1;
+    start.users[1].trajectory_id = 2;
+    start.users[1].initial_carrier_azimuth = 0.5;
+    unsigned char start_bytes[start_command_size(2)];
+    if (serialize_start_command(start, 2, start_bytes) != sizeof(StartCommand)
+        || std::memcmp(start_bytes, &start, sizeof(StartCommand)) != 0) {
+        std::cerr << "START command bytes differ from packed struct bytes" << std::endl;
+        return 2;
+    }
+
+    const double write_layout = ns_per_op(iterations, [&](size_t i) {
+        TrajectoryDataLayout::write(samples[i % BATCH], by_layout.data() + (i % BATCH) * TrajectoryDataLayout::size);
+    });
+    g_sink = by_layout[7];
+    const double write_memcpy = ns_per_op(iterations, [&](size_t i) {
+        std::memcpy(by_memcpy.data() + (i % BATCH) * sizeof(TrajectoryData), &samples[i % BATCH], sizeof(TrajectoryData));
+    });
+    g_sink = by_memcpy[7];
+
+    std::vector<TrajectoryData> decoded(BATCH);
+    const double read_layout = ns_per_op(iterations, [&](size_t i) {
+        TrajectoryDataLayout::read(by_layout.data() + (i % BATCH) * TrajectoryDataLayout::size, decoded[i % BATCH]);
+    });
+    g_sink = static_cast<unsigned char>(decoded[3].trajectory_data_seq_num);
+    const double read_memcpy = ns_per_op(iterations, [&](size_t i) {
+        std::memcpy(&decoded[i % BATCH], by_memcpy.data() + (i % BATCH) * sizeof(TrajectoryData), sizeof(TrajectoryData));
+    });
+    g_sink = static_cast<unsigned char>(decoded[5].trajectory_data_seq_num);
+
+    std::cout << "TrajectoryData (" << TrajectoryDataLayout::size << " B, " << TrajectoryDataLayout::field_count
+              << " fields), " << iterations << " iterations" << std::endl;
+    std::cout << "  write: layout " << write_layout << " ns, memcpy " << write_memcpy << " ns" << std::endl;
+    std::cout << "  read:  layout " << read_layout << " ns, memcpy " << read_memcpy << " ns" << std::endl;
+    std::cout << "  bytes identical to packed struct: yes" << std::endl;
+    return 0;
+}
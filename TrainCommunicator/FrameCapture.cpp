@@ -0,0 +1,275 @@
+#include "FrameCapture.h"
+#include "MillisecondTimer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr char CAPTURE_MAGIC[8] = {'T', 'R', 'N', 'C', 'A', 'P', '0', '1'};
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+constexpr auto WRITER_PERIOD = std::chrono::milliseconds(10); // 写入线程定时取走缓冲中的记录
+
+size_t padding_for(size_t size) {
+    return (CAPTURE_ALIGNMENT - size % CAPTURE_ALIGNMENT) % CAPTURE_ALIGNMENT;
+}
+} // namespace
+
+FrameCaptureWriter::FrameCaptureWriter(const std::string& path, CaptureOverflow overflow)
+    : overflow_(overflow), file_buffer_(WRITE_BUFFER_SIZE), ring_(RING_BYTES) {
+    static_assert((RING_BYTES & (RING_BYTES - 1)) == 0, "RING_BYTES must be a power of two");
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        throw std::runtime_error("Failed to create capture file: " + path);
+    }
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.header_size = CaptureFileHeaderLayout::size;
+    header.start_ns = MillisecondTimer::now_ns();
+    header.record_alignment = CAPTURE_ALIGNMENT;
+    unsigned char bytes[CaptureFileHeaderLayout::size];
+    CaptureFileHeaderLayout::write(header, bytes);
+    if (std::fwrite(bytes, sizeof(bytes), 1, file_) != 1) {
+        std::fclose(file_);
+        throw std::runtime_error("Failed to write capture header: " + path);
+    }
+    writer_ = std::thread(&FrameCaptureWriter::writer_loop, this);
+}
+
+FrameCaptureWriter::~FrameCaptureWriter() {
+    close();
+}
+
+void FrameCaptureWriter::put(size_t position, const void* data, size_t size) {
+    const size_t offset = position & (RING_BYTES - 1);
+    const size_t first = std::min(size, RING_BYTES - offset);
+    std::memcpy(ring_.data() + offset, data, first);
+    if (first < size) {
+        std::memcpy(ring_.data(), static_cast<const unsigned char*>(data) + first, size - first);
+    }
+}
+
+void FrameCaptureWriter::append(long long timestamp_ns, const void* const* parts, const size_t* sizes, size_t count,
+                                uint32_t send_status) {
+    if (!accepting_.load(std::memory_order_acquire) || failed_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    CaptureRecordHeader record{};
+    record.timestamp_ns = timestamp_ns;
+    record.send_status = send_status;
+    size_t frame_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        frame_size += sizes[i];
+    }
+    record.frame_size = static_cast<uint32_t>(frame_size);
+    const size_t padding = padding_for(frame_size);
+    const size_t record_size = CaptureRecordHeaderLayout::size + frame_size + padding;
+    if (record_size > RING_BYTES) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    while (RING_BYTES - (tail - head_.load(std::memory_order_acquire)) < record_size) {
+        if (overflow_ == CaptureOverflow::DROP || !accepting_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wake_cond_.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    unsigned char record_bytes[CaptureRecordHeaderLayout::size];
+    CaptureRecordHeaderLayout::write(record, record_bytes);
+    static constexpr unsigned char zeros[CAPTURE_ALIGNMENT] = {};
+    size_t position = tail;
+    put(position, record_bytes, sizeof(record_bytes));
+    position += sizeof(record_bytes);
+    for (size_t i = 0; i < count; ++i) {
+        put(position, parts[i], sizes[i]);
+        position += sizes[i];
+    }
+    put(position, zeros, padding);
+    tail_.store(tail + record_size, std::memory_order_release);
+    frames_.fetch_add(1, std::memory_order_relaxed);
+
+    // 平时由写入线程定时取走；积压超过一半时提前唤醒（不持锁通知，偶尔丢失也只推迟到下一次定时）
+    const size_t pending = tail + record_size - head_.load(std::memory_order_relaxed);
+    if (pending >= RING_BYTES / 2 && pending - record_size < RING_BYTES / 2) {
+        wake_cond_.notify_one();
+    }
+}
+
+bool FrameCaptureWriter::drain() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    const size_t offset = head & (RING_BYTES - 1);
+    const size_t size = tail - head;
+    const size_t first = std::min(size, RING_BYTES - offset);
+    bool ok = std::fwrite(ring_.data() + offset, 1, first, file_) == first;
+    if (ok && first < size) {
+        ok = std::fwrite(ring_.data(), 1, size - first, file_) == size - first;
+    }
+    if (!ok) {
+        failed_.store(true, std::memory_order_relaxed);
+    }
+    head_.store(tail, std::memory_order_release);
+    return true;
+}
+
+void FrameCaptureWriter::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_cond_.wait_for(lock, WRITER_PERIOD);
+        const bool stopping = stopping_;
+        const unsigned long long flush_requests = flush_requests_;
+        lock.unlock();
+        drain();
+        if (flush_requests != flushes_done_ || stopping) {
+            std::fflush(file_);
+        }
+        lock.lock();
+        flushes_done_ = flush_requests;
+        writer_done_ = stopping;
+        drained_cond_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void FrameCaptureWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return; // close 会写完全部记录
+    }
+    const unsigned long long request = ++flush_requests_;
+    wake_cond_.notify_one();
+    drained_cond_.wait(lock, [this, request] { return flushes_done_ >= request || writer_done_; });
+}
+
+void FrameCaptureWriter::close() {
+    accepting_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wake_cond_.notify_one();
+    writer_.join(); // 停止前最后一轮会写完环形缓冲中的全部记录
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+unsigned long long FrameCaptureWriter::frames_written() const {
+    return frames_.load(std::memory_order_relaxed);
+}
+
+unsigned long long FrameCaptureWriter::frames_dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+bool FrameCaptureWriter::failed() const {
+    return failed_.load(std::memory_order_relaxed);
+}
+
+FrameCaptureReader::~FrameCaptureReader() {
+    close();
+}
+
+bool FrameCaptureReader::open(const std::string& path) {
+    close();
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(CaptureFileHeaderLayout::size)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    // 回放按顺序读取整个文件
+    madvise(mapping, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    madvise(mapping, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+    base_ = static_cast<const unsigned char*>(mapping);
+    size_ = static_cast<size_t>(st.st_size);
+    mapped_ = true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    storage_.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (storage_.size() < CaptureFileHeaderLayout::size
+        || !in.read(reinterpret_cast<char*>(storage_.data()), static_cast<std::streamsize>(storage_.size()))) {
+        storage_.clear();
+        return false;
+    }
+    base_ = storage_.data();
+    size_ = storage_.size();
+#endif
+
+    const CaptureFileHeader header = CaptureFileHeaderLayout::read(base_);
+    if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 || header.version != CAPTURE_VERSION
+        || header.header_size < CaptureFileHeaderLayout::size || header.header_size > size_) {
+        close();
+        return false;
+    }
+    start_ns_ = header.start_ns;
+
+    size_t offset = header.header_size;
+    while (offset < size_) {
+        if (size_ - offset < CaptureRecordHeaderLayout::size) {
+            truncated_ = true;
+            break;
+        }
+        const CaptureRecordHeader record = CaptureRecordHeaderLayout::read(base_ + offset);
+        const size_t frame_offset = offset + CaptureRecordHeaderLayout::size;
+        if (size_ - frame_offset < record.frame_size) {
+            truncated_ = true;
+            break;
+        }
+        frames_.push_back(CapturedFrame{record.timestamp_ns, base_ + frame_offset, record.frame_size, record.send_status});
+        offset = frame_offset + record.frame_size + padding_for(record.frame_size);
+    }
+    return true;
+}
+
+void FrameCaptureReader::close() {
+#ifndef _WIN32
+    if (mapped_) {
+        munmap(const_cast<unsigned char*>(base_), size_);
+    }
+#endif
+    mapped_ = false;
+    storage_.clear();
+    storage_.shrink_to_fit();
+    base_ = nullptr;
+    size_ = 0;
+    frames_.clear();
+    start_ns_ = 0;
+    truncated_ = false;
+}
@@ -0,0 +1,170 @@
+//
+// Created by fyh on 25-8-21.
+//
+
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+#pragma once
+
+#include "WireLayout.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * 发送帧捕获文件格式（小端，按 8 字节对齐，只追加）：
+ *
+ *   CaptureFileHeader (64B)
+ *   { CaptureRecordHeader (16B) + 帧字节（含网络帧头）+ 补齐到 8 字节 } × N
+ *
+ * 记录头定长且对齐，整个文件可直接 mmap 后顺序遍历；写入中断只会留下不完整的尾记录，
+ * 读取时忽略并标记。
+ */
+#pragma pack(push, 1)
+struct CaptureFileHeader {
+    char magic[8];            // "TRNCAP01"
+    uint32_t version;         // CAPTURE_VERSION
+    uint32_t header_size;     // CaptureFileHeaderLayout::size
+    int64_t start_ns;         // 创建时刻（稳定时钟）
+    uint32_t record_alignment;
+    uint8_t reserved[36];
+};
+
+struct CaptureRecordHeader {
+    int64_t timestamp_ns;     // 交给 socket 的时刻（稳定时钟）
+    uint32_t frame_size;      // 帧字节数，不含补齐
+    uint32_t send_status;     // 发送结果（SendStatus 数值），0 表示成功；早期文件此处为保留的 0
+};
+#pragma pack(pop)
+
+using CaptureFileHeaderLayout = wire::Layout<CaptureFileHeader,
+    wire::Field<&CaptureFileHeader::magic>,
+    wire::Field<&CaptureFileHeader::version>,
+    wire::Field<&CaptureFileHeader::header_size>,
+    wire::Field<&CaptureFileHeader::start_ns>,
+    wire::Field<&CaptureFileHeader::record_alignment>,
+    wire::Reserved<36>>;
+
+using CaptureRecordHeaderLayout = wire::Layout<CaptureRecordHeader,
+    wire::Field<&CaptureRecordHeader::timestamp_ns>,
+    wire::Field<&CaptureRecordHeader::frame_size>,
+    wire::Field<&CaptureRecordHeader::send_status>>;
+
+static_assert(CaptureFileHeaderLayout::size == 64 && sizeof(CaptureFileHeader) == 64,
+              "CaptureFileHeader must be 64 bytes");
+static_assert(CaptureRecordHeaderLayout::size == 16 && sizeof(CaptureRecordHeader) == 16,
+              "CaptureRecordHeader must be 16 bytes");
+
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr size_t CAPTURE_ALIGNMENT = 8;
+
+// 捕获环形缓冲已满时 append 的处理方式
+enum class CaptureOverflow {
+    DROP,  // 丢弃该帧并计数，发送线程从不等待磁盘（实时仿真）
+    BLOCK  // 等待写入线程腾出空间，保证不丢帧（离线批量运行）
+};
+
+/**
+ * @brief 捕获文件写入器，由 UdpCommunicator 在每次发送后调用 append。
+ *
+ * append 只把记录拷贝进预分配的单生产者环形缓冲，由独立的写入线程批量写盘，
+ * 发送线程不执行文件 I/O、不加锁。同一时刻只能有一个线程调用 append；flush/close 可在其他线程调用。
+ */
+class FrameCaptureWriter {
+public:
+    static constexpr size_t RING_BYTES = 4 << 20;
+
+    // 创建（覆盖）文件、写入文件头并启动写入线程，失败时抛出 std::runtime_error
+    explicit FrameCaptureWriter(const std::string& path, CaptureOverflow overflow = CaptureOverflow::DROP);
+    ~FrameCaptureWriter();
+
+    FrameCaptureWriter(const FrameCaptureWriter&) = delete;
+    FrameCaptureWriter& operator=(const FrameCaptureWriter&) = delete;
+
+    // 追加一帧，帧由 count 段连续缓冲组成；send_status 为该帧的发送结果
+    void append(long long timestamp_ns, const void* const* parts, const size_t* sizes, size_t count,
+                uint32_t send_status = 0);
+    // 等待已追加的记录全部写入文件
+    void flush();
+    // 写完剩余记录、停止写入线程并关闭文件
+    void close();
+
+    // 已进入缓冲的帧数（close 之后即已写入文件的帧数，除非 failed）
+    unsigned long long frames_written() const;
+    // 因缓冲已满而丢弃的帧数
+    unsigned long long frames_dropped() const;
+    bool failed() const;
+
+private:
+    void writer_loop();
+    // 把 [head_, tail_) 写入文件，返回是否有数据
+    bool drain();
+    void put(size_t position, const void* data, size_t size);
+
+    CaptureOverflow overflow_;
+    std::FILE* file_ = nullptr;
+    std::vector<char> file_buffer_; // setvbuf 缓冲
+
+    std::vector<unsigned char> ring_;
+    alignas(64) std::atomic<size_t> head_{0}; // 写入线程独占
+    alignas(64) std::atomic<size_t> tail_{0}; // 生产者独占
+    alignas(64) std::atomic<bool> accepting_{true};
+    std::atomic<unsigned long long> frames_{0};
+    std::atomic<unsigned long long> dropped_{0};
+    std::atomic<bool> failed_{false};
+
+    std::mutex mutex_;
+    std::condition_variable wake_cond_;    // 唤醒写入线程
+    std::condition_variable drained_cond_; // 写入线程完成一轮写盘
+    bool stopping_ = false;
+    bool writer_done_ = false;
+    unsigned long long flush_requests_ = 0;
+    unsigned long long flushes_done_ = 0;
+    std::thread writer_;
+};
+
+// 捕获文件中的一帧，data 指向映射内存
+struct CapturedFrame {
+    long long timestamp_ns = 0;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    uint32_t send_status = 0; // 捕获时的发送结果，0 表示成功
+};
+
+/**
+ * @brief 只读打开捕获文件。POSIX 下 mmap 整个文件，其他平台读入内存；帧数据不再拷贝。
+ */
+class FrameCaptureReader {
+public:
+    FrameCaptureReader() = default;
+    ~FrameCaptureReader();
+
+    FrameCaptureReader(const FrameCaptureReader&) = delete;
+    FrameCaptureReader& operator=(const FrameCaptureReader&) = delete;
+
+    // 打开并建立帧索引；文件不存在或文件头不合法时返回 false
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<CapturedFrame>& frames() const { return frames_; }
+    long long start_ns() const { return start_ns_; }
+    // 文件末尾存在不完整的记录（写入被中断）
+    bool truncated() const { return truncated_; }
+
+private:
+    const unsigned char* base_ = nullptr;
+    size_t size_ = 0;
+    std::vector<unsigned char> storage_; // 非 mmap 平台的文件内容
+    bool mapped_ = false;
+    std::vector<CapturedFrame> frames_;
+    long long start_ns_ = 0;
+    bool truncated_ = false;
+};
+
+#endif //FRAMECAPTURE_H
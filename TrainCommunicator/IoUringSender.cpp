@@ -0,0 +1,261 @@
+#ifdef TRAINSIM_HAVE_IO_URING
+#include "IoUringSender.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+constexpr unsigned RING_ENTRIES = 256;
+constexpr unsigned SQ_THREAD_IDLE_MS = 2000; // SQPOLL 内核线程空闲多久后休眠
+
+// 与内核共享的队列指针，按 io_uring 约定以 acquire/release 访问
+unsigned load_acquire(unsigned* value) {
+    return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+}
+
+void store_release(unsigned* value, unsigned next) {
+    std::atomic_ref<unsigned>(*value).store(next, std::memory_order_release);
+}
+
+void* map_ring(int fd, size_t size, off_t offset) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+} // namespace
+
+IoUringSender::~IoUringSender() {
+    close();
+}
+
+bool IoUringSender::open(int sock, bool sq_poll) {
+    close();
+    io_uring_params params{};
+    if (sq_poll) {
+        params.flags = IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = SQ_THREAD_IDLE_MS;
+    } else {
+        // 完成项只在本线程进入内核时处理，避免额外的 IPI；旧内核不支持时退回默认设置
+        params.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SUBMIT_ALL;
+    }
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (fd < 0 && errno == EINVAL && !sq_poll) {
+        params = io_uring_params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    }
+    if (fd < 0) {
+        return false;
+    }
+    ring_fd_ = fd;
+    sq_poll_ = sq_poll;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = map_ring(fd, sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : map_ring(fd, cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = map_ring(fd, sqes_size_, IORING_OFF_SQES);
+    if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+        close();
+        return false;
+    }
+
+    auto* sq = static_cast<unsigned char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_flags_ = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+
+    auto* cq = static_cast<unsigned char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cq_entries_ = params.cq_entries;
+    cqes_ = cq + params.cq_off.cqes;
+
+    // 注册 socket，SQE 以下标 0 + IOSQE_FIXED_FILE 引用
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_FILES, &sock, 1) < 0) {
+        close();
+        return false;
+    }
+
+    arena_.assign(SLOT_COUNT * SLOT_SIZE, 0);
+    slots_.assign(SLOT_COUNT, Slot{});
+    iovecs_.assign(SLOT_COUNT, iovec{});
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        iovecs_[i].iov_base = arena_.data() + i * SLOT_SIZE;
+    }
+    completions_.reserve(cq_entries_);
+    next_slot_ = 0;
+    in_flight_ = 0;
+    rebuild_messages();
+    return true;
+}
+
+void IoUringSender::close() {
+    if (ring_fd_ < 0) {
+        return;
+    }
+    // 内核可能仍在读取槽位与 msghdr，释放前等待在途发送完成
+    wait_all();
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+        munmap(sq_ring_, sq_ring_size_);
+    }
+    ::close(ring_fd_);
+    ring_fd_ = -1;
+    sq_ring_ = cq_ring_ = sqes_ = cqes_ = nullptr;
+    in_flight_ = 0;
+}
+
+void IoUringSender::set_destinations(const sockaddr_in* addresses, size_t count) {
+    addresses_.assign(addresses, addresses + count);
+    rebuild_messages();
+}
+
+void IoUringSender::rebuild_messages() {
+    const size_t destinations = addresses_.size();
+    messages_.assign(SLOT_COUNT * destinations, msghdr{});
+    for (size_t slot = 0; slot < SLOT_COUNT && !iovecs_.empty(); ++slot) {
+        for (size_t d = 0; d < destinations; ++d) {
+            msghdr& msg = messages_[slot * destinations + d];
+            msg.msg_name = &addresses_[d];
+            msg.msg_namelen = sizeof(sockaddr_in);
+            msg.msg_iov = &iovecs_[slot];
+            msg.msg_iovlen = 1;
+        }
+    }
+}
+
+bool IoUringSender::enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    if (sq_poll_) {
+        // 内核线程已休眠时需要显式唤醒；读取标志前的全屏障与内核写入 NEED_WAKEUP 配对
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref<unsigned>(*sq_flags_).load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP) {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        } else if (min_complete == 0) {
+            return true;
+        }
+    }
+    while (true) {
+        const long rc = syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0);
+        if (rc >= 0) {
+            return true;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+void IoUringSender::reap() {
+    unsigned head = *cq_head_;
+    const unsigned tail = load_acquire(cq_tail_);
+    const auto* cqes = static_cast<const io_uring_cqe*>(cqes_);
+    while (head != tail) {
+        const io_uring_cqe& cqe = cqes[head & cq_mask_];
+        const size_t slot = static_cast<size_t>(cqe.user_data >> 32);
+        Completion completion;
+        completion.destination = static_cast<uint32_t>(cqe.user_data & 0xFFFFFFFFu);
+        completion.frame_size = slots_[slot].frame_size;
+        completion.result = cqe.res;
+        completions_.push_back(completion);
+        --slots_[slot].pending;
+        --in_flight_;
+        ++head;
+    }
+    store_release(cq_head_, head);
+}
+
+bool IoUringSender::wait_for(size_t slot, size_t sqes) {
+    // 槽位仍被内核使用、完成队列可能溢出或提交队列空间不足时等待至少一个完成项
+    while (true) {
+        reap();
+        const unsigned unsubmitted = *sq_tail_ - load_acquire(sq_head_);
+        if (slots_[slot].pending == 0 && in_flight_ + sqes <= cq_entries_ && unsubmitted + sqes <= sq_entries_) {
+            return true;
+        }
+        if (!enter(unsubmitted, 1, IORING_ENTER_GETEVENTS)) {
+            return false;
+        }
+    }
+}
+
+bool IoUringSender::submit(const void* const* parts, const size_t* sizes, size_t count) {
+    size_t frame_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        frame_size += sizes[i];
+    }
+    const size_t destinations = addresses_.size();
+    if (ring_fd_ < 0 || !fits(frame_size) || destinations == 0 || destinations > sq_entries_) {
+        return false;
+    }
+    const size_t slot = next_slot_;
+    if (!wait_for(slot, destinations)) {
+        return false;
+    }
+
+    unsigned char* data = arena_.data() + slot * SLOT_SIZE;
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(data + offset, parts[i], sizes[i]);
+        offset += sizes[i];
+    }
+    iovecs_[slot].iov_len = frame_size;
+    slots_[slot].frame_size = static_cast<uint32_t>(frame_size);
+    slots_[slot].pending = static_cast<uint32_t>(destinations);
+
+    auto* sqes = static_cast<io_uring_sqe*>(sqes_);
+    unsigned tail = *sq_tail_;
+    for (size_t d = 0; d < destinations; ++d) {
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_SENDMSG;
+        sqe.flags = IOSQE_FIXED_FILE;
+        sqe.fd = 0;
+        sqe.addr = reinterpret_cast<uint64_t>(&messages_[slot * destinations + d]);
+        sqe.len = 1;
+        sqe.msg_flags = MSG_NOSIGNAL;
+        sqe.user_data = (static_cast<uint64_t>(slot) << 32) | d;
+        sq_array_[index] = index;
+        ++tail;
+    }
+    store_release(sq_tail_, tail);
+    in_flight_ += destinations;
+    next_slot_ = (slot + 1) % SLOT_COUNT;
+
+    // 提交失败的 SQE 留在队列中，下次进入内核时一并提交
+    enter(tail - load_acquire(sq_head_), 0, 0);
+    reap();
+    return true;
+}
+
+void IoUringSender::wait_all() {
+    while (in_flight_ > 0) {
+        reap();
+        if (in_flight_ == 0) {
+            break;
+        }
+        if (!enter(*sq_tail_ - load_acquire(sq_head_), 1, IORING_ENTER_GETEVENTS)) {
+            break;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,109 @@
+//
+// Created by fyh on 25-8-22.
+//
+
+#ifndef IOURINGSENDER_H
+#define IOURINGSENDER_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief UdpCommunicator 的 io_uring 发送后端（仅 Linux，直接使用系统调用，不依赖 liburing）。
+ *
+ * 帧被拷贝进预分配的槽位区，每个目的地对应一个预先构造好的 msghdr，发送时只需填写 SQE；
+ * socket 通过 IORING_REGISTER_FILES 注册，省去每次提交的文件查找。一帧的全部目的地在一次
+ * io_uring_enter 中提交；SQPOLL 模式下由内核线程轮询提交队列，稳态发送不再进入内核。
+ *
+ * 发送异步完成：完成项在后续 submit / wait_all 时收割，调用方从 completions() 取走并统计。
+ * 非线程安全，由 UdpCommunicator 加锁调用。
+ */
+class IoUringSender {
+public:
+    // 一个目的地的一次发送结果；result 为发送字节数或负的 errno
+    struct Completion {
+        uint32_t destination = 0;
+        uint32_t frame_size = 0;
+        int result = 0;
+    };
+
+    static constexpr size_t SLOT_SIZE = 8192;  // 单帧上限（容纳 32 用户的编组帧），更大的帧由调用方走同步路径
+    static constexpr size_t SLOT_COUNT = 64;   // 在途帧数上限
+
+    IoUringSender() = default;
+    ~IoUringSender();
+
+    IoUringSender(const IoUringSender&) = delete;
+    IoUringSender& operator=(const IoUringSender&) = delete;
+
+    // 内核不支持、被禁用或资源不足时返回 false，调用方应回退到 sendmsg
+    bool open(int sock, bool sq_poll);
+    void close();
+    bool is_open() const { return ring_fd_ >= 0; }
+
+    // 目的地变化前必须先 wait_all
+    void set_destinations(const sockaddr_in* addresses, size_t count);
+    size_t destination_count() const { return addresses_.size(); }
+
+    bool fits(size_t frame_size) const { return frame_size <= SLOT_SIZE; }
+
+    // 把 count 段缓冲拼成一帧发往全部目的地；槽位或队列已满时先等待部分完成。失败时返回 false 且未提交任何 SQE
+    bool submit(const void* const* parts, const size_t* sizes, size_t count);
+    // 等待全部在途发送完成
+    void wait_all();
+
+    const std::vector<Completion>& completions() const { return completions_; }
+    void clear_completions() { completions_.clear(); }
+    size_t in_flight() const { return in_flight_; }
+
+private:
+    struct Slot {
+        uint32_t frame_size = 0;
+        uint32_t pending = 0;   // 尚未完成的目的地数
+    };
+
+    bool enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+    void reap();
+    bool wait_for(size_t slot, size_t sqes);
+    void rebuild_messages();
+
+    int ring_fd_ = -1;
+    bool sq_poll_ = false;
+
+    // 提交队列（内核共享内存）
+    void* sq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_flags_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    void* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    // 完成队列；支持 IORING_FEAT_SINGLE_MMAP 时与提交队列共用一次映射
+    void* cq_ring_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    unsigned cq_entries_ = 0;
+    void* cqes_ = nullptr;
+
+    std::vector<unsigned char> arena_;      // SLOT_COUNT × SLOT_SIZE
+    std::vector<Slot> slots_;
+    size_t next_slot_ = 0;
+    size_t in_flight_ = 0;                  // 已提交未完成的 SQE 数
+    std::vector<sockaddr_in> addresses_;
+    std::vector<iovec> iovecs_;             // 每个槽位一个
+    std::vector<msghdr> messages_;          // 每个 (槽位, 目的地) 一个
+    std::vector<Completion> completions_;
+};
+
+#endif //IOURINGSENDER_H
@@ -1,11 +1,36 @@
 #include "MillisecondTimer.h"
+#include "TickScheduler.h"
+#include "SimClock.h"
 #include <iostream>
 
-MillisecondTimer::MillisecondTimer()
-    : running_(false), intervalTicks_(0), clockFrequency_(0), startTime_(0) {
-    if (!QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&clockFrequency_))) {
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <ctime>
+#endif
+
+#ifndef TRAINSIM_TIMER_SPIN_US
+#define TRAINSIM_TIMER_SPIN_US 0
+#endif
+
+namespace {
+#ifdef _WIN32
+long long query_frequency() {
+    LARGE_INTEGER frequency;
+    if (!QueryPerformanceFrequency(&frequency)) {
         throw std::runtime_error("High-resolution performance counter not supported.");
     }
+    return frequency.QuadPart;
+}
+#endif
+} // namespace
+
+MillisecondTimer::MillisecondTimer()
+    : running_(false), intervalNs_(0), spinWindowNs_(TRAINSIM_TIMER_SPIN_US * 1000LL), startTime_(0) {
+#ifdef _WIN32
+    query_frequency(); // 不支持高精度计数器时尽早报错
+#endif
 }
 
 MillisecondTimer::~MillisecondTimer() {
@@ -16,8 +41,38 @@ void MillisecondTimer::setCallback(std::function<void()> callback) {
     tickCallback_ = callback;
 }
 
+void MillisecondTimer::setThreadInitializer(std::function<void()> initializer) {
+    threadInitializer_ = std::move(initializer);
+}
+
 void MillisecondTimer::setInterval(int ms) {
-    intervalTicks_ = static_cast<long long>((static_cast<double>(ms) * clockFrequency_) / 1000.0);
+    intervalNs_ = static_cast<long long>(ms) * 1000000LL;
+}
+
+void MillisecondTimer::setSpinWindow(int us) {
+    spinWindowNs_ = static_cast<long long>(us) * 1000LL;
+}
+
+void MillisecondTimer::setOverrunPolicy(TimerOverrunPolicy policy) {
+    overrunPolicy_.store(policy);
+}
+
+void MillisecondTimer::setPhase(int us) {
+    phaseNs_ = static_cast<long long>(us) * 1000LL;
+}
+
+void MillisecondTimer::setScheduler(std::shared_ptr<TickScheduler> scheduler) {
+    if (running_) {
+        return;
+    }
+    scheduler_ = std::move(scheduler);
+}
+
+void MillisecondTimer::setClock(std::shared_ptr<SimClock> clock) {
+    if (running_) {
+        return;
+    }
+    clock_ = std::move(clock);
 }
 
 void MillisecondTimer::start() {
@@ -26,9 +81,29 @@ void MillisecondTimer::start() {
     }
     running_ = true;
 
-    long long current_ticks;
-    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&current_ticks));
-    startTime_.store(current_ticks);
+    startTime_.store(current_ns());
+    tickCount_ = 0;
+    tickIndex_ = 0;
+    overrunCount_ = 0;
+    skippedTicks_ = 0;
+    totalLatenessNs_ = 0;
+    maxLatenessNs_ = 0;
+    lastLatenessNs_ = 0;
+    threadCpuNs_ = 0;
+    threadWallNs_ = 0;
+
+    origin_ = startTime_.load() + phaseNs_;
+    nextTick_ = 1;
+
+    if (scheduler_ && !clock_) {
+        schedulerHandle_ = scheduler_->add(origin_ + intervalNs_, [this](long long current_ns) {
+            if (!running_) {
+                return -1LL;
+            }
+            return run_tick(current_ns);
+        });
+        return;
+    }
 
     if (timerThread_.joinable()) {
         timerThread_.join();
@@ -46,6 +121,13 @@ void MillisecondTimer::start() {
 void MillisecondTimer::stop() {
     running_ = false;
     startTime_.store(0);
+    if (clock_) {
+        clock_->interrupt(); // 手动时钟下定时器线程可能无限期等待
+    }
+    if (scheduler_ && schedulerHandle_ != 0) {
+        scheduler_->remove(schedulerHandle_);
+        schedulerHandle_ = 0;
+    }
     if (timerThread_.joinable()) {
         timerThread_.join();
     }
@@ -55,28 +137,149 @@ double MillisecondTimer::get_elapsed_time_sec() const {
     if (!running_.load()) {
         return 0.0;
     }
+    const long long elapsed_ns = current_ns() - startTime_.load();
+    return static_cast<double>(elapsed_ns) / 1e9;
+}
+
+unsigned long long MillisecondTimer::get_tick_index() const {
+    return tickIndex_.load(std::memory_order_relaxed);
+}
+
+long long MillisecondTimer::get_last_lateness_ns() const {
+    return lastLatenessNs_.load(std::memory_order_relaxed);
+}
+
+TimerStats MillisecondTimer::get_stats() const {
+    TimerStats stats;
+    stats.ticks = tickCount_.load(std::memory_order_relaxed);
+    stats.overruns = overrunCount_.load(std::memory_order_relaxed);
+    stats.skipped_ticks = skippedTicks_.load(std::memory_order_relaxed);
+    if (stats.ticks > 0) {
+        stats.mean_lateness_us = static_cast<double>(totalLatenessNs_.load(std::memory_order_relaxed))
+                                 / static_cast<double>(stats.ticks) / 1000.0;
+    }
+    stats.max_lateness_us = static_cast<double>(maxLatenessNs_.load(std::memory_order_relaxed)) / 1000.0;
+    stats.wall_time_sec = static_cast<double>(threadWallNs_.load(std::memory_order_relaxed)) / 1e9;
+    stats.cpu_time_sec = static_cast<double>(threadCpuNs_.load(std::memory_order_relaxed)) / 1e9;
+    return stats;
+}
 
-    long long current_ticks;
-    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&current_ticks));
+long long MillisecondTimer::now_ns() {
+#ifdef _WIN32
+    static const long long frequency = query_frequency();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // 拆分整数与余数部分，避免乘以 1e9 时溢出
+    const long long seconds = counter.QuadPart / frequency;
+    const long long remainder = counter.QuadPart % frequency;
+    return seconds * 1000000000LL + remainder * 1000000000LL / frequency;
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+}
 
-    long long start_ticks = startTime_.load();
-    long long elapsed_ticks = current_ticks - start_ticks;
+long long MillisecondTimer::thread_cpu_ns() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    auto to_ns = [](const FILETIME& ft) {
+        return ((static_cast<long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 100LL;
+    };
+    return to_ns(kernel) + to_ns(user);
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+}
 
-    return static_cast<double>(elapsed_ticks) / clockFrequency_;
+long long MillisecondTimer::current_ns() const {
+    return clock_ ? clock_->now_ns() : now_ns();
+}
+
+void MillisecondTimer::sleep_until_ns(long long deadline_ns, long long spin_window_ns) {
+#if !defined(_WIN32) && !defined(TRAINSIM_TIMER_SPIN_ONLY)
+    // 先以绝对时刻休眠到自旋窗口起点，避免周期间隔内持续占用CPU
+    const long long wake_ns = deadline_ns - spin_window_ns;
+    if (wake_ns > now_ns()) {
+        timespec ts{};
+        ts.tv_sec = static_cast<time_t>(wake_ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(wake_ns % 1000000000LL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+    }
+#endif
+    while (now_ns() < deadline_ns) {
+    }
+}
+
+long long MillisecondTimer::run_tick(long long current_ns) {
+    const long long deadline = origin_ + static_cast<long long>(nextTick_) * intervalNs_;
+    long long lateness = current_ns - deadline;
+    if (intervalNs_ > 0 && lateness >= intervalNs_) {
+        overrunCount_.fetch_add(1, std::memory_order_relaxed);
+        switch (overrunPolicy_.load(std::memory_order_relaxed)) {
+            case TimerOverrunPolicy::CATCH_UP:
+                // 保持 k 不变，后续已过期的周期会被连续触发
+                break;
+            case TimerOverrunPolicy::SKIP: {
+                const auto missed = static_cast<unsigned long long>(lateness / intervalNs_);
+                nextTick_ += missed;
+                lateness -= static_cast<long long>(missed) * intervalNs_;
+                skippedTicks_.fetch_add(missed, std::memory_order_relaxed);
+                break;
+            }
+            case TimerOverrunPolicy::STRETCH:
+                origin_ += lateness;
+                lateness = 0;
+                break;
+        }
+    }
+
+    lastLatenessNs_.store(lateness, std::memory_order_relaxed);
+    totalLatenessNs_.fetch_add(lateness, std::memory_order_relaxed);
+    if (lateness > maxLatenessNs_.load(std::memory_order_relaxed)) {
+        maxLatenessNs_.store(lateness, std::memory_order_relaxed);
+    }
+    tickCount_.fetch_add(1, std::memory_order_relaxed);
+    tickIndex_.store(nextTick_, std::memory_order_relaxed);
+
+    if (tickCallback_) {
+        tickCallback_();
+    }
+    ++nextTick_;
+    return origin_ + static_cast<long long>(nextTick_) * intervalNs_;
 }
 
 void MillisecondTimer::threadProc() {
-    long long currentTime = 0;
-    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&currentTime));
-    long long nextTriggerTime = currentTime + intervalTicks_;
+    if (threadInitializer_) {
+        threadInitializer_();
+        if (!running_) {
+            return;
+        }
+        // 初始化可能耗时数毫秒（预缺页），周期基准在其完成后才确定，避免首批周期整体迟到
+        startTime_.store(current_ns());
+        origin_ = startTime_.load() + phaseNs_;
+    }
+    const long long thread_start_ns = now_ns();
+    const long long cpu_start_ns = thread_cpu_ns();
 
+    long long deadline = origin_ + intervalNs_;
     while (running_) {
-        while (currentTime < nextTriggerTime) {
-            QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&currentTime));
-        }
-        nextTriggerTime = currentTime + intervalTicks_;
-        if (tickCallback_) {
-            tickCallback_();
+        if (clock_) {
+            if (!clock_->wait_until(deadline, spinWindowNs_, running_)) {
+                continue;
+            }
+        } else {
+            sleep_until_ns(deadline, spinWindowNs_);
         }
+        deadline = run_tick(current_ns());
+
+        threadCpuNs_.store(thread_cpu_ns() - cpu_start_ns, std::memory_order_relaxed);
+        threadWallNs_.store(now_ns() - thread_start_ns, std::memory_order_relaxed);
     }
 }
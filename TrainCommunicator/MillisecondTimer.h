@@ -2,18 +2,81 @@
 #define MILLISECONDTIMER_H
 #pragma once
 
-#include <windows.h>
 #include <functional>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <stdexcept>
 
+class TickScheduler;
+class SimClock;
+
+// 回调耗时超过一个周期（错过下一期望时刻）时的处理策略
+enum class TimerOverrunPolicy {
+    CATCH_UP, // 立即连续补发错过的周期，保持周期序号与墙钟对齐
+    SKIP,     // 丢弃错过的周期，下一次触发直接使用当前墙钟对应的周期序号
+    STRETCH   // 以本次实际触发时刻为新基准，后续周期整体顺延
+};
+
+// 定时器运行统计，用于评估触发抖动与CPU占用
+struct TimerStats {
+    unsigned long long ticks = 0;      // 已触发次数
+    unsigned long long overruns = 0;   // 发生超期（滞后达到一个周期）的次数
+    unsigned long long skipped_ticks = 0; // SKIP 策略下丢弃的周期数
+    double mean_lateness_us = 0.0;     // 实际触发时刻相对期望时刻的平均滞后 (us)
+    double max_lateness_us = 0.0;      // 最大滞后 (us)
+    double wall_time_sec = 0.0;        // 定时器线程运行的墙钟时间
+    double cpu_time_sec = 0.0;         // 定时器线程消耗的CPU时间
+    double cpu_usage() const { return wall_time_sec > 0.0 ? cpu_time_sec / wall_time_sec : 0.0; }
+};
+
+/**
+ * @brief 毫秒级周期定时器，在独立线程中按固定间隔调用回调。
+ *
+ * 第 k 次触发的期望时刻固定为 start + k·interval，回调的执行时间不会累积成漂移；
+ * 超期时按 TimerOverrunPolicy 处理。
+ *
+ * Windows 下使用 QueryPerformanceCounter 忙等；POSIX 下默认使用 CLOCK_MONOTONIC 的
+ * 绝对时刻 clock_nanosleep 休眠，仅在期望时刻前的短窗口内自旋。构建时定义
+ * TRAINSIM_TIMER_SPIN_ONLY 可在 POSIX 下切换回纯自旋实现以便对比。
+ *
+ * 通过 setScheduler 挂接到共享的 TickScheduler 后不再创建独立线程，周期、相位与
+ * 超期策略仍由本定时器维护。此时 TimerStats 中的线程墙钟/CPU时间不再统计。
+ *
+ * 通过 setClock 指定虚拟时钟（倍率或手动步进）后，期望时刻、滞后与运行时间均以虚拟时间计算；
+ * 共享调度器只支持墙钟，设置了虚拟时钟时定时器总是使用独立线程。
+ */
 class MillisecondTimer {
 public:
     MillisecondTimer();
     ~MillisecondTimer();
     void setCallback(std::function<void()> callback);
+    /**
+     * @brief 设置在触发线程上、首个周期之前执行一次的初始化函数（如实时调度设置、预缺页）。
+     * 周期基准在初始化完成后确定。挂接共享调度器时不执行：调度线程由多个定时器共用，
+     * 线程级设置应作用于调度器本身。
+     */
+    void setThreadInitializer(std::function<void()> initializer);
     void setInterval(int ms);
+    /**
+     * @brief 设置休眠结束后到期望时刻之间的自旋窗口，仅对休眠后端生效。
+     * @param us 自旋窗口（微秒），0 表示完全依赖休眠唤醒
+     */
+    void setSpinWindow(int us);
+    void setOverrunPolicy(TimerOverrunPolicy policy);
+    /**
+     * @brief 设置首个周期相对启动时刻的额外偏移，用于在共享调度器上错开多个实例的触发时刻。
+     * @param us 相位偏移（微秒）
+     */
+    void setPhase(int us);
+    /**
+     * @brief 由共享调度器驱动本定时器；传入空指针恢复独立线程。需在 start() 之前设置。
+     */
+    void setScheduler(std::shared_ptr<TickScheduler> scheduler);
+    /**
+     * @brief 使用虚拟时钟驱动本定时器；传入空指针恢复墙钟。需在 start() 之前设置。
+     */
+    void setClock(std::shared_ptr<SimClock> clock);
     void start();
     void stop();
 
@@ -23,15 +86,56 @@ public:
      */
     double get_elapsed_time_sec() const;
 
+    /**
+     * @brief 获取当前（或最近一次）回调对应的周期序号 k，从 1 开始。
+     * SKIP 策略下序号会跳过被丢弃的周期，因此可用于换算与墙钟一致的仿真时间。
+     */
+    unsigned long long get_tick_index() const;
+
+    TimerStats get_stats() const;
+
+    // 当前（或最近一次）触发相对期望时刻的滞后 (ns)，供回调内的时延统计使用
+    long long get_last_lateness_ns() const;
+
+    static long long now_ns();          // 单调时钟 (ns)
+    // 以绝对时刻休眠到 deadline_ns（单调时钟），最后 spin_window_ns 内自旋
+    static void sleep_until_ns(long long deadline_ns, long long spin_window_ns);
+
 private:
     void threadProc();
+    // 处理当前周期（统计、超期策略、回调），返回下一周期的期望时刻
+    long long run_tick(long long current_ns);
+    static long long thread_cpu_ns();   // 当前线程CPU时间 (ns)
+    long long current_ns() const;       // 定时器所用时钟（虚拟或墙钟）的当前时刻
+
     std::thread timerThread_;
     std::atomic<bool> running_;
-    long long clockFrequency_;
-    long long intervalTicks_;
+    long long intervalNs_;
+    long long spinWindowNs_;
+    std::atomic<TimerOverrunPolicy> overrunPolicy_{TimerOverrunPolicy::CATCH_UP};
+    long long phaseNs_ = 0;
     std::function<void()> tickCallback_;
+    std::function<void()> threadInitializer_;
+    std::shared_ptr<TickScheduler> scheduler_;
+    std::shared_ptr<SimClock> clock_;
+    unsigned long long schedulerHandle_ = 0;
+
+    // 第 k 个周期的期望时刻 = origin + k * interval，仅由触发线程访问
+    long long origin_ = 0;
+    unsigned long long nextTick_ = 1;
+
+    // 用于存储定时器启动时刻（ns），使用原子类型保证线程安全
+    std::atomic<long long> startTime_;
 
-    // 用于存储定时器启动时刻的滴答数，使用原子类型保证线程安全
-    std::atomic<long long> startTime_; 
+    // 统计量，由定时器线程写入
+    std::atomic<unsigned long long> tickCount_{0};
+    std::atomic<unsigned long long> tickIndex_{0};
+    std::atomic<unsigned long long> overrunCount_{0};
+    std::atomic<unsigned long long> skippedTicks_{0};
+    std::atomic<long long> totalLatenessNs_{0};
+    std::atomic<long long> maxLatenessNs_{0};
+    std::atomic<long long> lastLatenessNs_{0};
+    std::atomic<long long> threadCpuNs_{0};
+    std::atomic<long long> threadWallNs_{0};
 };
-#endif //MILLISECONDTIMER_H
\ No newline at end of file
+#endif //MILLISECONDTIMER_H
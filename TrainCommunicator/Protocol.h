@@ -5,10 +5,13 @@
 #define PROTOCOL_H
 #pragma once
 
+#include "WireLayout.h"
+#include <cstddef>
 #include <cstdint>
 
 /**
  * 网络注入协议（V2.4）结构定义，严格 1 字节对齐。
+ * 结构体是内存中的表示；收发一律经过文件末尾的 wire::Layout 描述做显式小端序列化。
  */
 #pragma pack(push, 1)
 
@@ -34,11 +37,11 @@ struct StartUserParams {
     double reserved_after_pitch[9];
 };
 
-// 启动指令：32B 头 + N * 200B 用户块
+// 启动指令：32B 头 + N * 200B 用户块；结构体只容纳前两个用户，更多用户由 serialize_start_command 追加
 struct StartCommand {
-    uint64_t command_word;           // 0x000000000ABC0001（单）或 0x000000000ABC0002（双）
+    uint64_t command_word;           // 0x000000000ABC0001（单）、0x000000000ABC0002（双）或 0x000000000ABC0004（N 用户）
     uint32_t reserved_after_cmd;     // 4B 保留
-    uint32_t data_length;            // 232（单用户）或 432（双用户）
+    uint32_t data_length;            // 32 + N × 200，如 232（单用户）、432（双用户）
     uint64_t simulation_start_time;  // 2006-01-01 至今的毫秒数
     uint64_t simulation_duration;    // 仿真持续时间
     StartUserParams users[2];
@@ -97,5 +100,193 @@ struct DualTrajectoryData {
 };
 static_assert(sizeof(DualTrajectoryData) == 2 * sizeof(TrajectoryData), "DualTrajectoryData should be a simple concatenation of two user payloads");
 
+// 编组输出：每节车一个用户，单帧最多 MAX_CONSIST_USERS 个用户块直接拼接
+constexpr size_t MAX_CONSIST_USERS = 32;
+struct ConsistTrajectoryData {
+    TrajectoryData users[MAX_CONSIST_USERS];
+};
+
+constexpr uint32_t NETWORK_FRAME_FLAG = 0xA5A56666;
+
+// 指令字
+constexpr uint64_t COMMAND_START_SINGLE = 0x000000000ABC0001ULL;
+constexpr uint64_t COMMAND_START_DUAL = 0x000000000ABC0002ULL;
+constexpr uint64_t COMMAND_STOP = 0x000000000ABC0003ULL;
+// 扩展：3 个及以上用户的 START，用户数由 data_length 给出（0x0ABC0003 已被 STOP 占用，不能沿用“低位即用户数”）
+constexpr uint64_t COMMAND_START_MULTI = 0x000000000ABC0004ULL;
+constexpr uint64_t COMMAND_STREAM_FEEDBACK = 0x000000000ABC00FFULL;
+
+/**
+ * 回执（扩展协议，模拟器 -> 仿真器）：帧头 + 40B，发往仿真器的源地址。
+ * command_word 为被回复的指令字时表示对该指令的应答；为 COMMAND_STREAM_FEEDBACK 时
+ * 是对轨迹数据流的周期性反馈，报告已收到的最大序号与累计帧数。
+ */
+struct AckMessage {
+    uint64_t command_word;
+    uint32_t status;              // 0 表示接受，其余为模拟器定义的错误码
+    uint32_t reserved;
+    uint64_t last_seq_num;        // 已收到的最大轨迹序号（user1）
+    uint64_t received_count;      // 本次仿真累计收到的轨迹帧数
+    uint64_t peer_time_ns;        // 模拟器本地时间，仅供记录
+};
+static_assert(sizeof(AckMessage) == 40, "AckMessage size must be 40 bytes");
+
+#pragma pack(pop)
+
+// ---- 线上布局 ----
+
+using NetworkFrameHeaderLayout = wire::Layout<NetworkFrameHeader,
+    wire::Field<&NetworkFrameHeader::frame_flag>,
+    wire::Field<&NetworkFrameHeader::frame_number>,
+    wire::Field<&NetworkFrameHeader::frame_length>,
+    wire::Field<&NetworkFrameHeader::reserved>>;
+
+using StartUserLayout = wire::Layout<StartUserParams,
+    wire::Field<&StartUserParams::trajectory_id>,
+    wire::Field<&StartUserParams::trajectory_type>,
+    wire::Field<&StartUserParams::initial_user_pos_x>,
+    wire::Field<&StartUserParams::initial_user_pos_y>,
+    wire::Field<&StartUserParams::initial_user_pos_z>,
+    wire::Field<&StartUserParams::reserved_after_pos>,
+    wire::Field<&StartUserParams::initial_carrier_roll>,
+    wire::Field<&StartUserParams::initial_carrier_azimuth>,
+    wire::Field<&StartUserParams::initial_carrier_pitch>,
+    wire::Field<&StartUserParams::reserved_after_pitch>>;
+
+// START 指令中用户块之前的 32B
+using StartCommandHeaderLayout = wire::Layout<StartCommand,
+    wire::Field<&StartCommand::command_word>,
+    wire::Field<&StartCommand::reserved_after_cmd>,
+    wire::Field<&StartCommand::data_length>,
+    wire::Field<&StartCommand::simulation_start_time>,
+    wire::Field<&StartCommand::simulation_duration>>;
+
+using StopCommandLayout = wire::Layout<StopCommand,
+    wire::Field<&StopCommand::command_word>,
+    wire::Field<&StopCommand::reserved_after_cmd>,
+    wire::Field<&StopCommand::data_length>,
+    wire::Field<&StopCommand::reserved_doubles>>;
+
+using TrajectoryDataLayout = wire::Layout<TrajectoryData,
+    wire::Field<&TrajectoryData::trajectory_type>,
+    wire::Field<&TrajectoryData::trajectory_id>,
+    wire::Field<&TrajectoryData::trajectory_data_seq_num>,
+    wire::Field<&TrajectoryData::reserved_page4_ll>,
+    wire::Field<&TrajectoryData::trajectory_time>,
+    wire::Field<&TrajectoryData::user_pos_x>,
+    wire::Field<&TrajectoryData::user_pos_y>,
+    wire::Field<&TrajectoryData::user_pos_z>,
+    wire::Field<&TrajectoryData::user_vel_x>,
+    wire::Field<&TrajectoryData::user_vel_y>,
+    wire::Field<&TrajectoryData::user_vel_z>,
+    wire::Field<&TrajectoryData::user_acc_x>,
+    wire::Field<&TrajectoryData::user_acc_y>,
+    wire::Field<&TrajectoryData::user_acc_z>,
+    wire::Field<&TrajectoryData::user_jerk_x>,
+    wire::Field<&TrajectoryData::user_jerk_y>,
+    wire::Field<&TrajectoryData::user_jerk_z>,
+    wire::Field<&TrajectoryData::reserved_page5_ll>,
+    wire::Field<&TrajectoryData::carrier_roll>,
+    wire::Field<&TrajectoryData::carrier_azimuth>,
+    wire::Field<&TrajectoryData::carrier_pitch>,
+    wire::Field<&TrajectoryData::carrier_angular_vel_x>,
+    wire::Field<&TrajectoryData::carrier_angular_vel_y>,
+    wire::Field<&TrajectoryData::carrier_angular_vel_z>,
+    wire::Field<&TrajectoryData::carrier_angular_acc_x>,
+    wire::Field<&TrajectoryData::carrier_angular_acc_y>,
+    wire::Field<&TrajectoryData::carrier_angular_acc_z>,
+    wire::Field<&TrajectoryData::carrier_angular_jerk_x>,
+    wire::Field<&TrajectoryData::carrier_angular_jerk_y>,
+    wire::Field<&TrajectoryData::carrier_angular_jerk_z>>;
+
+using AckMessageLayout = wire::Layout<AckMessage,
+    wire::Field<&AckMessage::command_word>,
+    wire::Field<&AckMessage::status>,
+    wire::Field<&AckMessage::reserved>,
+    wire::Field<&AckMessage::last_seq_num>,
+    wire::Field<&AckMessage::received_count>,
+    wire::Field<&AckMessage::peer_time_ns>>;
+
+// 线上长度由协议规定，与结构体大小无关；这里同时确认描述没有遗漏成员
+static_assert(NetworkFrameHeaderLayout::size == 16 && NetworkFrameHeaderLayout::size == sizeof(NetworkFrameHeader));
+static_assert(StartUserLayout::size == 200 && StartUserLayout::size == sizeof(StartUserParams));
+static_assert(StartCommandHeaderLayout::size == 32);
+static_assert(StopCommandLayout::size == 232 && StopCommandLayout::size == sizeof(StopCommand));
+static_assert(TrajectoryDataLayout::size == 248 && TrajectoryDataLayout::size == sizeof(TrajectoryData));
+static_assert(AckMessageLayout::size == 40 && AckMessageLayout::size == sizeof(AckMessage));
+
+// START 指令载荷长度：32B 头 + N × 200B 用户块
+constexpr size_t start_command_size(size_t user_count) {
+    return StartCommandHeaderLayout::size + user_count * StartUserLayout::size;
+}
+static_assert(start_command_size(2) == sizeof(StartCommand));
+
+// N 用户 START 的指令字：1、2 用户沿用 V2.4 的单/双用户指令字
+constexpr uint64_t start_command_word(size_t user_count) {
+    return user_count == 1 ? COMMAND_START_SINGLE : user_count == 2 ? COMMAND_START_DUAL : COMMAND_START_MULTI;
+}
+
+// 由指令字与载荷长度得到 START 的用户数；不是 START 或长度不符时返回 0
+constexpr size_t start_command_user_count(uint64_t command_word, size_t payload_size) {
+    if (payload_size < start_command_size(1) || (payload_size - StartCommandHeaderLayout::size) % StartUserLayout::size != 0) {
+        return 0;
+    }
+    const size_t user_count = (payload_size - StartCommandHeaderLayout::size) / StartUserLayout::size;
+    if (command_word == COMMAND_START_SINGLE) return user_count == 1 ? 1 : 0;
+    if (command_word == COMMAND_START_DUAL) return user_count == 2 ? 2 : 0;
+    if (command_word == COMMAND_START_MULTI) return user_count >= 3 ? user_count : 0;
+    return 0;
+}
+
+// 序列化 START 指令头与 user_count 个用户块，返回写入的字节数
+inline size_t serialize_start_command(const StartCommand& header, const StartUserParams* users, size_t user_count,
+                                      unsigned char* out) {
+    StartCommandHeaderLayout::write(header, out);
+    for (size_t i = 0; i < user_count; ++i) {
+        StartUserLayout::write(users[i], out + start_command_size(i));
+    }
+    return start_command_size(user_count);
+}
+
+// 序列化 START 指令的前 user_count（至多 2）个用户
+inline size_t serialize_start_command(const StartCommand& command, size_t user_count, unsigned char* out) {
+    return serialize_start_command(command, command.users, user_count, out);
+}
+
+// 按线上格式写入网络帧头
+inline void write_frame_header(unsigned char* out, uint32_t payload_length) {
+    NetworkFrameHeader header{};
+    header.frame_flag = NETWORK_FRAME_FLAG;
+    header.frame_number = 0;        // 协议要求固定为 0
+    header.frame_length = payload_length;
+    header.reserved = 0;
+    NetworkFrameHeaderLayout::write(header, out);
+}
+
+#pragma pack(push, 1)
+/**
+ * 帧头与载荷在内存中连续排列的完整网络帧，可原地填充后直接作为一个 UDP 报文发送。
+ * 发送长度为 sizeof(NetworkFrameHeader) + header.frame_length，载荷可只用前一部分
+ * （例如 N 个用户时只发送 ConsistTrajectoryData 的前 N 个用户块）。
+ */
+template<typename Payload>
+struct WireFrame {
+    NetworkFrameHeader header;
+    Payload payload;
+
+    // 按线上格式写入帧头并返回整帧发送长度
+    size_t set_payload_length(uint32_t payload_length) {
+        write_frame_header(reinterpret_cast<unsigned char*>(&header), payload_length);
+        return sizeof(NetworkFrameHeader) + payload_length;
+    }
+
+    unsigned char* payload_bytes() { return reinterpret_cast<unsigned char*>(&payload); }
+    const unsigned char* payload_bytes() const { return reinterpret_cast<const unsigned char*>(&payload); }
+};
+
+using TrajectoryFrame = WireFrame<ConsistTrajectoryData>;
+static_assert(sizeof(TrajectoryFrame) == sizeof(NetworkFrameHeader) + sizeof(ConsistTrajectoryData),
+              "WireFrame must be contiguous without padding");
+
 #pragma pack(pop)
 #endif //PROTOCOL_H
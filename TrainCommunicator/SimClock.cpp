@@ -0,0 +1,62 @@
+#include "SimClock.h"
+#include "MillisecondTimer.h"
+#include <stdexcept>
+
+long long RealClock::now_ns() const {
+    return MillisecondTimer::now_ns();
+}
+
+bool RealClock::wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>&) {
+    MillisecondTimer::sleep_until_ns(deadline_ns, spin_window_ns);
+    return true;
+}
+
+ScaledClock::ScaledClock(double scale)
+    : scale_(scale), origin_real_ns_(MillisecondTimer::now_ns()) {
+    if (!(scale > 0.0)) {
+        throw std::invalid_argument("ScaledClock scale must be positive.");
+    }
+}
+
+long long ScaledClock::now_ns() const {
+    const long long elapsed_real = MillisecondTimer::now_ns() - origin_real_ns_;
+    return origin_real_ns_ + static_cast<long long>(static_cast<double>(elapsed_real) * scale_);
+}
+
+bool ScaledClock::wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>&) {
+    // 换算回墙钟上的期望时刻；向上取整保证醒来时虚拟时间已到达
+    const double real_offset = static_cast<double>(deadline_ns - origin_real_ns_) / scale_;
+    const long long real_deadline = origin_real_ns_ + static_cast<long long>(real_offset) + 1;
+    MillisecondTimer::sleep_until_ns(real_deadline, spin_window_ns);
+    return true;
+}
+
+ManualClock::ManualClock(long long start_ns) : now_ns_(start_ns) {}
+
+long long ManualClock::now_ns() const {
+    return now_ns_.load(std::memory_order_acquire);
+}
+
+bool ManualClock::wait_until(long long deadline_ns, long long, const std::atomic<bool>& keep_running) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [&] {
+        return now_ns_.load(std::memory_order_acquire) >= deadline_ns || !keep_running.load();
+    });
+    return now_ns_.load(std::memory_order_acquire) >= deadline_ns;
+}
+
+void ManualClock::interrupt() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cond_.notify_all();
+}
+
+void ManualClock::advance(long long delta_ns) {
+    if (delta_ns <= 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        now_ns_.fetch_add(delta_ns, std::memory_order_acq_rel);
+    }
+    cond_.notify_all();
+}
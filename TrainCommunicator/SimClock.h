@@ -0,0 +1,81 @@
+//
+// Created by fyh on 25-8-19.
+//
+
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// 仿真时钟类型
+enum class ClockMode {
+    REAL,   // 与墙钟同步
+    SCALED, // 按固定倍率加速/减速的墙钟（如 10×、100×）
+    MANUAL  // 仅在外部调用 advance 时前进
+};
+
+/**
+ * @brief 驱动 MillisecondTimer 的虚拟时钟。
+ *
+ * 定时器的期望时刻、滞后与运行时间都以虚拟时间计算，因此周期序号、trajectory_time
+ * 与仿真时刻在任意倍率下保持一致；线程CPU统计仍使用真实时间。
+ */
+class SimClock {
+public:
+    virtual ~SimClock() = default;
+
+    // 当前虚拟时间 (ns)，单调递增
+    virtual long long now_ns() const = 0;
+
+    /**
+     * @brief 阻塞直到虚拟时间到达 deadline_ns，或 keep_running 变为 false。
+     * @param spin_window_ns 基于墙钟的时钟在到达前的自旋窗口（真实时间）
+     * @return 虚拟时间已到达 deadline_ns 时返回 true
+     */
+    virtual bool wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>& keep_running) = 0;
+
+    // 唤醒所有正在等待的线程，使其重新检查 keep_running
+    virtual void interrupt() {}
+};
+
+// 墙钟（与 MillisecondTimer 默认行为一致）
+class RealClock : public SimClock {
+public:
+    long long now_ns() const override;
+    bool wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>& keep_running) override;
+};
+
+// 倍率时钟：虚拟时间流速为墙钟的 scale 倍，创建时与墙钟对齐
+class ScaledClock : public SimClock {
+public:
+    explicit ScaledClock(double scale);
+    long long now_ns() const override;
+    bool wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>& keep_running) override;
+    double scale() const { return scale_; }
+
+private:
+    double scale_;
+    long long origin_real_ns_;
+};
+
+// 手动步进时钟：由测试或外部调度显式推进
+class ManualClock : public SimClock {
+public:
+    explicit ManualClock(long long start_ns = 0);
+    long long now_ns() const override;
+    bool wait_until(long long deadline_ns, long long spin_window_ns, const std::atomic<bool>& keep_running) override;
+    void interrupt() override;
+
+    // 将虚拟时间推进 delta_ns（负值被忽略），唤醒到期的等待者
+    void advance(long long delta_ns);
+
+private:
+    std::atomic<long long> now_ns_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+#endif //SIMCLOCK_H
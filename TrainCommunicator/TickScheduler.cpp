@@ -0,0 +1,156 @@
+#include "TickScheduler.h"
+#include "MillisecondTimer.h"
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+// 当前调度线程正在执行的任务，用于识别回调内的自注销
+thread_local TickScheduler::Handle tls_running_handle = 0;
+
+// MillisecondTimer::now_ns 与 steady_clock 同源（POSIX 为 CLOCK_MONOTONIC，Windows 为 QPC），
+// 期望时刻可直接换算为绝对时间点，等待不因计算与入睡之间的延迟而后移
+std::chrono::steady_clock::time_point to_time_point(long long ns) {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+} // namespace
+
+TickScheduler::TickScheduler(size_t thread_count, int spin_window_us)
+    : spin_window_ns_(static_cast<long long>(spin_window_us) * 1000LL) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&TickScheduler::worker_loop, this);
+#ifdef _WIN32
+        HANDLE hThread = reinterpret_cast<HANDLE>(threads_.back().native_handle());
+        if (hThread != nullptr) {
+            SetThreadPriority(hThread, THREAD_PRIORITY_HIGHEST);
+        }
+#endif
+    }
+}
+
+TickScheduler::~TickScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_cond_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+TickScheduler::Handle TickScheduler::add(long long first_deadline_ns, TickHandler handler) {
+    Handle handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handle = next_handle_++;
+        Task& task = tasks_[handle];
+        task.handler = std::move(handler);
+        task.deadline = first_deadline_ns;
+        heap_.push({first_deadline_ns, handle});
+    }
+    wake_cond_.notify_all();
+    return handle;
+}
+
+void TickScheduler::remove(Handle handle) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = tasks_.find(handle);
+    if (it == tasks_.end()) {
+        return;
+    }
+    if (!it->second.in_flight) {
+        tasks_.erase(it); // 堆中的残留项在出堆时丢弃
+        return;
+    }
+    it->second.removed = true;
+    if (tls_running_handle == handle) {
+        return; // 回调返回后由调度线程删除
+    }
+    done_cond_.wait(lock, [this, handle] { return tasks_.find(handle) == tasks_.end(); });
+}
+
+size_t TickScheduler::task_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+std::shared_ptr<TickScheduler> TickScheduler::shared() {
+    static std::mutex shared_mutex;
+    static std::weak_ptr<TickScheduler> instance;
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    auto scheduler = instance.lock();
+    if (!scheduler) {
+        scheduler = std::make_shared<TickScheduler>();
+        instance = scheduler;
+    }
+    return scheduler;
+}
+
+void TickScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        // 丢弃已注销或正在执行的任务留在堆中的旧项
+        while (!heap_.empty()) {
+            const HeapItem& top = heap_.top();
+            auto it = tasks_.find(top.handle);
+            if (it == tasks_.end() || it->second.in_flight || it->second.deadline != top.deadline) {
+                heap_.pop();
+                continue;
+            }
+            break;
+        }
+        if (heap_.empty()) {
+            wake_cond_.wait(lock);
+            continue;
+        }
+
+        const HeapItem next = heap_.top();
+        const long long now = MillisecondTimer::now_ns();
+        const long long wake_at = next.deadline - spin_window_ns_;
+        if (now < wake_at) {
+            // 休眠期间可能加入更早的任务，被唤醒后重新取堆顶
+            wake_cond_.wait_until(lock, to_time_point(wake_at));
+            continue;
+        }
+        if (now < next.deadline) {
+            lock.unlock();
+            while (MillisecondTimer::now_ns() < next.deadline) {
+            }
+            lock.lock();
+            continue;
+        }
+
+        heap_.pop();
+        Task& task = tasks_[next.handle];
+        task.in_flight = true;
+
+        lock.unlock();
+        tls_running_handle = next.handle;
+        // unordered_map 的元素引用在其他元素增删时保持有效，且执行期间本任务不会被删除
+        const long long next_deadline = task.handler(MillisecondTimer::now_ns());
+        tls_running_handle = 0;
+        lock.lock();
+
+        task.in_flight = false;
+        if (task.removed || next_deadline < 0) {
+            tasks_.erase(next.handle);
+            done_cond_.notify_all();
+        } else {
+            task.deadline = next_deadline;
+            heap_.push({next_deadline, next.handle});
+            if (threads_.size() > 1) {
+                wake_cond_.notify_one();
+            }
+        }
+    }
+}
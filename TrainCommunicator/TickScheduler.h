@@ -0,0 +1,85 @@
+//
+// Created by fyh on 25-8-18.
+//
+
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 由少量线程驱动任意数量周期任务的共享调度器（最小堆按期望时刻排序）。
+ *
+ * 每个任务自行决定下一次期望时刻（周期、相位与超期策略由任务维护），
+ * 调度线程只负责在期望时刻到来时调用它。多个仿真实例共用时，
+ * 线程数与CPU占用不再随实例数增长。
+ */
+class TickScheduler {
+public:
+    using Handle = unsigned long long;
+    /**
+     * @brief 任务回调。
+     * @param now_ns 实际触发时刻（与 MillisecondTimer 相同的单调时钟，ns）
+     * @return 下一次期望时刻 (ns)；返回负值表示任务结束并自动注销
+     */
+    using TickHandler = std::function<long long(long long now_ns)>;
+
+    /**
+     * @param thread_count 调度线程数
+     * @param spin_window_us 期望时刻前的自旋窗口（微秒），0 表示仅依赖条件变量唤醒
+     */
+    explicit TickScheduler(size_t thread_count = 1, int spin_window_us = 0);
+    ~TickScheduler();
+
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    // 注册任务，首次在 first_deadline_ns 触发
+    Handle add(long long first_deadline_ns, TickHandler handler);
+
+    // 注销任务；若任务正在执行则等待其返回（在任务自身回调内调用时不等待）
+    void remove(Handle handle);
+
+    size_t task_count() const;
+    size_t thread_count() const { return threads_.size(); }
+
+    // 进程内共享的默认调度器（单线程），首次调用时创建
+    static std::shared_ptr<TickScheduler> shared();
+
+private:
+    struct Task {
+        TickHandler handler;
+        long long deadline = 0;
+        bool in_flight = false;
+        bool removed = false;
+    };
+
+    struct HeapItem {
+        long long deadline;
+        Handle handle;
+        bool operator>(const HeapItem& other) const { return deadline > other.deadline; }
+    };
+
+    void worker_loop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cond_;  // 新任务加入或停止
+    std::condition_variable done_cond_;  // 任务回调执行完毕
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<>> heap_;
+    std::unordered_map<Handle, Task> tasks_;
+    Handle next_handle_ = 1;
+    bool stopping_ = false;
+    long long spin_window_ns_;
+    std::vector<std::thread> threads_;
+};
+
+#endif //TICKSCHEDULER_H
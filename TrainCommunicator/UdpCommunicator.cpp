@@ -3,49 +3,509 @@
 //
 #include "UdpCommunicator.h"
 #include "Protocol.h"
-#include <winsock2.h>
-#include <ws2tcpip.h>
+#include "FrameCapture.h"
+#include "MillisecondTimer.h"
 #include <stdexcept>
-#include <vector>
 #include <cstring>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
 
 // 链接 Winsock
 #pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#ifdef TRAINSIM_HAVE_IO_URING
+#include "IoUringSender.h"
+#endif
+#else
+#include <poll.h>
+#endif
+#endif
+
+namespace {
+constexpr size_t MAX_UDP_PAYLOAD = 65507;       // IPv4 UDP 报文载荷上限
+constexpr size_t FANOUT_BATCH = 32;             // 单次 sendmmsg 的最大报文数（栈上数组）
+#if !defined(__linux__)
+constexpr int RECEIVE_POLL_TIMEOUT_MS = 100;    // 无 epoll/eventfd 时检查停止标志的间隔
+#endif
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+
+int last_socket_error() { return WSAGetLastError(); }
+bool is_would_block(int error) { return error == WSAEWOULDBLOCK || error == WSAETIMEDOUT; }
+void close_socket(SocketHandle sock) { closesocket(sock); }
+#else
+using SocketHandle = int;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+
+int last_socket_error() { return errno; }
+bool is_would_block(int error) { return error == EAGAIN || error == EWOULDBLOCK; }
+void close_socket(SocketHandle sock) { close(sock); }
+#endif
+} // namespace
+
+const char* send_status_name(SendStatus status) {
+    switch (status) {
+        case SendStatus::OK:                return "OK";
+        case SendStatus::NOT_INITIALIZED:   return "NOT_INITIALIZED";
+        case SendStatus::PAYLOAD_TOO_LARGE: return "PAYLOAD_TOO_LARGE";
+        case SendStatus::WOULD_BLOCK:       return "WOULD_BLOCK";
+        case SendStatus::NETWORK_ERROR:     return "NETWORK_ERROR";
+        case SendStatus::PARTIAL:           return "PARTIAL";
+    }
+    return "UNKNOWN";
+}
+
+const char* send_backend_name(SendBackend backend) {
+    switch (backend) {
+        case SendBackend::SENDMSG:         return "sendmsg";
+        case SendBackend::IO_URING:        return "io_uring";
+        case SendBackend::IO_URING_SQPOLL: return "io_uring+sqpoll";
+    }
+    return "unknown";
+}
 
 // PImpl 模式的实现
 class UdpCommunicator::UdpImpl {
 public:
-    SOCKET sock;
-    sockaddr_in server_addr;
+    // 单个目的地及其计数；std::deque 追加元素时不移动已有元素，计数可用原子量
+    struct Destination {
+        sockaddr_in addr{};
+        std::string ip;
+        int port = 0;
+        std::atomic<unsigned long long> packets_sent{0};
+        std::atomic<unsigned long long> failures{0};
+        std::atomic<int> last_error_code{0};
+    };
 
-    UdpImpl() : sock(INVALID_SOCKET) {
+    UdpCommunicator& owner;
+    SocketHandle sock;
+    std::deque<Destination> destinations;
+    SendBackend backend = SendBackend::SENDMSG;
+#ifdef TRAINSIM_HAVE_IO_URING
+    // 提交队列只能有一个生产者；start/stop 指令与周期发送可能来自不同线程
+    std::mutex uring_mutex;
+    std::unique_ptr<IoUringSender> uring;
+#endif
+
+    // 接收线程
+    std::thread receiver_thread;
+    std::atomic<bool> receiving{false};
+    ReceiveHandler receive_handler;
+#if defined(__linux__)
+    int epoll_fd = -1;
+    int wake_fd = -1; // eventfd，stop_receiver 写入以唤醒 epoll_wait
+#endif
+    std::atomic<unsigned long long> datagrams_received{0};
+    std::atomic<unsigned long long> bytes_received{0};
+    std::atomic<unsigned long long> malformed{0};
+
+    explicit UdpImpl(UdpCommunicator& owner) : owner(owner), sock(INVALID_SOCKET_HANDLE) {
+#ifdef _WIN32
         // 初始化 Winsock
         WSADATA wsaData;
         if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
             throw std::runtime_error("WSAStartup failed.");
         }
+#endif
     }
 
     ~UdpImpl() {
-        if (sock != INVALID_SOCKET) {
-            closesocket(sock);
+        stop_receiving();
+#ifdef TRAINSIM_HAVE_IO_URING
+        uring.reset();
+#endif
+        if (sock != INVALID_SOCKET_HANDLE) {
+            close_socket(sock);
         }
+#ifdef _WIN32
         WSACleanup();
+#endif
+    }
+
+    bool start_receiving(ReceiveHandler handler) {
+        if (receiving.load() || sock == INVALID_SOCKET_HANDLE) {
+            return false;
+        }
+        // 未发送过的 socket 尚无本地端口，显式绑定到任意端口以便对端回复
+        sockaddr_in local{};
+        socklen_t local_len = sizeof(local);
+        if (getsockname(sock, reinterpret_cast<sockaddr*>(&local), &local_len) == 0 && local.sin_port == 0) {
+            local.sin_family = AF_INET;
+            local.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bind(sock, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+                return false;
+            }
+        }
+#if defined(__linux__)
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd < 0 || wake_fd < 0) {
+            close_receiver_fds();
+            return false;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = sock;
+        const bool socket_added = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, &event) == 0;
+        event.data.fd = wake_fd;
+        // 任一注册失败时接收线程将永远等不到 socket 或停止通知
+        if (!socket_added || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) != 0) {
+            close_receiver_fds();
+            return false;
+        }
+#endif
+        receive_handler = std::move(handler);
+        receiving = true;
+        receiver_thread = std::thread(&UdpImpl::receive_loop, this);
+        return true;
+    }
+
+    void stop_receiving() {
+        if (!receiving.exchange(false)) {
+            return;
+        }
+#if defined(__linux__)
+        const uint64_t one = 1;
+        (void)!write(wake_fd, &one, sizeof(one));
+#endif
+        if (receiver_thread.joinable()) {
+            receiver_thread.join();
+        }
+#if defined(__linux__)
+        close_receiver_fds();
+#endif
+    }
+
+#if defined(__linux__)
+    void close_receiver_fds() {
+        if (epoll_fd >= 0) {
+            close(epoll_fd);
+            epoll_fd = -1;
+        }
+        if (wake_fd >= 0) {
+            close(wake_fd);
+            wake_fd = -1;
+        }
+    }
+#endif
+
+    // 等待 socket 可读；返回 false 表示需要重新检查停止标志
+    bool wait_readable() {
+#if defined(__linux__)
+        epoll_event events[2];
+        const int count = epoll_wait(epoll_fd, events, 2, -1);
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == sock) {
+                return true;
+            }
+        }
+        return false;
+#elif defined(_WIN32)
+        WSAPOLLFD entry{};
+        entry.fd = sock;
+        entry.events = POLLRDNORM;
+        return WSAPoll(&entry, 1, RECEIVE_POLL_TIMEOUT_MS) > 0;
+#else
+        pollfd entry{};
+        entry.fd = sock;
+        entry.events = POLLIN;
+        return poll(&entry, 1, RECEIVE_POLL_TIMEOUT_MS) > 0;
+#endif
+    }
+
+    void receive_loop() {
+        // 单个 UDP 报文的上限，接收缓冲只分配一次
+        std::vector<unsigned char> buffer(MAX_UDP_PAYLOAD + 1);
+        while (receiving.load(std::memory_order_acquire)) {
+            if (!wait_readable()) {
+                continue;
+            }
+            // 一次唤醒读空 socket
+            while (true) {
+#ifdef _WIN32
+                u_long pending = 0;
+                if (ioctlsocket(sock, FIONREAD, &pending) != 0 || pending == 0) {
+                    break;
+                }
+                const int bytes = recv(sock, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+#else
+                const ssize_t bytes = recv(sock, buffer.data(), buffer.size(), MSG_DONTWAIT);
+#endif
+                if (bytes < 0) {
+                    // 对端端口不可达等 ICMP 错误也会在这里报告，忽略后继续接收
+                    if (is_would_block(last_socket_error())) {
+                        break;
+                    }
+                    continue;
+                }
+                dispatch(buffer.data(), static_cast<size_t>(bytes));
+            }
+        }
+    }
+
+    void dispatch(const unsigned char* data, size_t size) {
+        datagrams_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(size, std::memory_order_relaxed);
+        if (size < NetworkFrameHeaderLayout::size) {
+            malformed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const NetworkFrameHeader header = NetworkFrameHeaderLayout::read(data);
+        if (header.frame_flag != NETWORK_FRAME_FLAG || header.frame_length != size - NetworkFrameHeaderLayout::size) {
+            malformed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        receive_handler(header, data + NetworkFrameHeaderLayout::size, header.frame_length);
+    }
+
+    static void account(Destination& destination, long long bytes, size_t frame_size, int error, SendResult& result) {
+        if (bytes == static_cast<long long>(frame_size)) {
+            destination.packets_sent.fetch_add(1, std::memory_order_relaxed);
+            result.bytes_sent += frame_size;
+            ++result.destinations_ok;
+            return;
+        }
+        destination.failures.fetch_add(1, std::memory_order_relaxed);
+        destination.last_error_code.store(error, std::memory_order_relaxed);
+        if (bytes > 0) {
+            result.bytes_sent += static_cast<size_t>(bytes);
+        }
+        if (result.ok()) {
+            result.error_code = error;
+            result.status = bytes >= 0 ? SendStatus::PARTIAL
+                          : is_would_block(error) ? SendStatus::WOULD_BLOCK : SendStatus::NETWORK_ERROR;
+        }
+    }
+
+#ifdef TRAINSIM_HAVE_IO_URING
+    // 把已收割的完成项计入目的地与通信器的计数，调用方持有 uring_mutex
+    void account_completions() {
+        for (const IoUringSender::Completion& completion : uring->completions()) {
+            Destination& destination = destinations[completion.destination];
+            if (completion.result == static_cast<int>(completion.frame_size)) {
+                destination.packets_sent.fetch_add(1, std::memory_order_relaxed);
+                owner.packets_sent_.fetch_add(1, std::memory_order_relaxed);
+                owner.bytes_sent_.fetch_add(completion.frame_size, std::memory_order_relaxed);
+                continue;
+            }
+            const int error = completion.result < 0 ? -completion.result : 0;
+            destination.failures.fetch_add(1, std::memory_order_relaxed);
+            destination.last_error_code.store(error, std::memory_order_relaxed);
+            owner.failures_.fetch_add(1, std::memory_order_relaxed);
+            owner.last_failure_.store(completion.result >= 0 ? SendStatus::PARTIAL
+                                      : is_would_block(error) ? SendStatus::WOULD_BLOCK : SendStatus::NETWORK_ERROR,
+                                      std::memory_order_relaxed);
+            owner.last_error_code_.store(error, std::memory_order_relaxed);
+            if (completion.result > 0) {
+                owner.bytes_sent_.fetch_add(static_cast<unsigned long long>(completion.result), std::memory_order_relaxed);
+            }
+        }
+        uring->clear_completions();
+    }
+
+    void drain_uring() {
+        uring->wait_all();
+        account_completions();
+    }
+
+    // 提交成功返回 true，此时计数在完成时更新；返回 false 时由调用方同步发送
+    bool submit_uring(const void* const* parts, const size_t* sizes, size_t count, SendResult& result) {
+        std::lock_guard<std::mutex> lock(uring_mutex);
+        if (!uring) {
+            return false;
+        }
+        if (uring->destination_count() != destinations.size()) {
+            drain_uring();
+            std::vector<sockaddr_in> addresses;
+            for (const Destination& destination : destinations) {
+                addresses.push_back(destination.addr);
+            }
+            uring->set_destinations(addresses.data(), addresses.size());
+        }
+        size_t frame_size = 0;
+        for (size_t i = 0; i < count; ++i) {
+            frame_size += sizes[i];
+        }
+        const bool submitted = uring->submit(parts, sizes, count);
+        if (!submitted) {
+            // 同步路径不能越过仍在途的帧
+            drain_uring();
+            return false;
+        }
+        account_completions();
+        result.bytes_sent = frame_size * destinations.size();
+        result.destinations_ok = destinations.size();
+        return true;
+    }
+#endif
+
+    // 以 count 段（1 或 2）连续缓冲组成一个报文，向全部目的地发送。
+    // 返回 true 表示发送已完成、result 可直接计入统计；false 表示已异步提交，计数在完成时更新
+    bool send_gather(const void* const* parts, const size_t* sizes, size_t count, SendResult& result) {
+#ifdef TRAINSIM_HAVE_IO_URING
+        if (backend != SendBackend::SENDMSG && submit_uring(parts, sizes, count, result)) {
+            return false;
+        }
+#endif
+        size_t frame_size = 0;
+        for (size_t i = 0; i < count; ++i) {
+            frame_size += sizes[i];
+        }
+#ifdef _WIN32
+        WSABUF buffers[2];
+        for (size_t i = 0; i < count; ++i) {
+            buffers[i].buf = static_cast<CHAR*>(const_cast<void*>(parts[i]));
+            buffers[i].len = static_cast<ULONG>(sizes[i]);
+        }
+        for (Destination& destination : destinations) {
+            DWORD bytes_sent = 0;
+            const int rc = WSASendTo(sock, buffers, static_cast<DWORD>(count), &bytes_sent, 0,
+                                     reinterpret_cast<const sockaddr*>(&destination.addr), sizeof(destination.addr),
+                                     nullptr, nullptr);
+            const int error = rc == 0 ? 0 : last_socket_error();
+            account(destination, rc == 0 ? static_cast<long long>(bytes_sent) : -1, frame_size, error, result);
+        }
+#else
+        // 所有目的地共享同一组 iovec，内核逐个发送，用户态只准备一次
+        iovec iov[2];
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = const_cast<void*>(parts[i]);
+            iov[i].iov_len = sizes[i];
+        }
+
+        auto send_one = [&](Destination& destination) {
+            msghdr msg{};
+            msg.msg_name = &destination.addr;
+            msg.msg_namelen = sizeof(sockaddr_in);
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            ssize_t rc;
+            do {
+                rc = sendmsg(sock, &msg, MSG_NOSIGNAL);
+            } while (rc < 0 && errno == EINTR);
+            account(destination, rc, frame_size, rc < 0 ? errno : 0, result);
+        };
+
+#if defined(__linux__)
+        if (destinations.size() == 1) {
+            send_one(destinations.front());
+            return true;
+        }
+
+        mmsghdr messages[FANOUT_BATCH];
+        size_t base = 0;
+        while (base < destinations.size()) {
+            const size_t batch = std::min(FANOUT_BATCH, destinations.size() - base);
+            for (size_t i = 0; i < batch; ++i) {
+                messages[i] = mmsghdr{};
+                messages[i].msg_hdr.msg_name = &destinations[base + i].addr;
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = iov;
+                messages[i].msg_hdr.msg_iovlen = count;
+            }
+            // sendmmsg 在第 k 个报文出错时返回 k，错误在下一次调用时才报告，因此逐段推进
+            size_t offset = 0;
+            while (offset < batch) {
+                const int rc = sendmmsg(sock, messages + offset, static_cast<unsigned int>(batch - offset), MSG_NOSIGNAL);
+                if (rc < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    account(destinations[base + offset], -1, frame_size, errno, result);
+                    ++offset;
+                    continue;
+                }
+                for (int i = 0; i < rc; ++i) {
+                    account(destinations[base + offset + i], messages[offset + i].msg_len, frame_size, 0, result);
+                }
+                offset += static_cast<size_t>(rc);
+            }
+            base += batch;
+        }
+#else
+        for (Destination& destination : destinations) {
+            send_one(destination);
+        }
+#endif
+#endif
+        return true;
     }
 };
 
-UdpCommunicator::UdpCommunicator(const std::string& ip, int port) : pImpl(new UdpImpl()) {
+bool UdpCommunicator::add_destination(const std::string& ip, int port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) <= 0) {
+        return false;
+    }
+    UdpImpl::Destination& destination = pImpl->destinations.emplace_back();
+    destination.addr = addr;
+    destination.ip = ip;
+    destination.port = port;
+    return true;
+}
+
+size_t UdpCommunicator::destination_count() const {
+    return pImpl->destinations.size();
+}
+
+bool UdpCommunicator::set_multicast_ttl(int ttl) {
+    if (pImpl->sock == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+#ifdef _WIN32
+    const DWORD value = static_cast<DWORD>(ttl);
+    return setsockopt(pImpl->sock, IPPROTO_IP, IP_MULTICAST_TTL,
+                      reinterpret_cast<const char*>(&value), sizeof(value)) == 0;
+#else
+    const unsigned char value = static_cast<unsigned char>(ttl);
+    return setsockopt(pImpl->sock, IPPROTO_IP, IP_MULTICAST_TTL, &value, sizeof(value)) == 0;
+#endif
+}
+
+std::vector<DestinationStats> UdpCommunicator::get_destination_stats() const {
+    std::vector<DestinationStats> stats;
+    stats.reserve(pImpl->destinations.size());
+    for (const UdpImpl::Destination& destination : pImpl->destinations) {
+        DestinationStats entry;
+        entry.ip = destination.ip;
+        entry.port = destination.port;
+        entry.packets_sent = destination.packets_sent.load(std::memory_order_relaxed);
+        entry.failures = destination.failures.load(std::memory_order_relaxed);
+        entry.last_error_code = destination.last_error_code.load(std::memory_order_relaxed);
+        stats.push_back(entry);
+    }
+    return stats;
+}
+
+UdpCommunicator::UdpCommunicator(const std::string& ip, int port) : pImpl(new UdpImpl(*this)) {
     pImpl->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (pImpl->sock == INVALID_SOCKET) {
+    if (pImpl->sock == INVALID_SOCKET_HANDLE) {
         delete pImpl;
         throw std::runtime_error("Socket creation failed.");
     }
 
-    memset(&pImpl->server_addr, 0, sizeof(pImpl->server_addr));
-    pImpl->server_addr.sin_family = AF_INET;
-    pImpl->server_addr.sin_port = htons(port);
-    // 将IP地址字符串转换为网络格式
-    if (inet_pton(AF_INET, ip.c_str(), &pImpl->server_addr.sin_addr) <= 0) {
+    // 将IP地址字符串转换为网络格式，作为第一个目的地
+    if (!add_destination(ip, port)) {
         delete pImpl;
         throw std::runtime_error("Invalid address/ Address not supported.");
     }
@@ -55,31 +515,140 @@ UdpCommunicator::~UdpCommunicator() {
     delete pImpl;
 }
 
-bool UdpCommunicator::send(const void* payload, size_t payload_size) {
-    if (pImpl->sock == INVALID_SOCKET) {
-        return false;
+SendResult UdpCommunicator::send(const void* payload, size_t payload_size) {
+    SendResult result;
+    if (pImpl->sock == INVALID_SOCKET_HANDLE) {
+        result.status = SendStatus::NOT_INITIALIZED;
+        record(result);
+        return result;
+    }
+    if (payload_size > MAX_UDP_PAYLOAD - NetworkFrameHeaderLayout::size) {
+        result.status = SendStatus::PAYLOAD_TOO_LARGE;
+        record(result);
+        return result;
+    }
+
+    // 1. 准备帧头（栈上），与载荷一起以分散/聚集方式发送，无需拼接
+    unsigned char header[NetworkFrameHeaderLayout::size];
+    write_frame_header(header, static_cast<uint32_t>(payload_size));
+
+    // 2. 发送数据包
+    const void* parts[2] = {header, payload};
+    const size_t sizes[2] = {sizeof(header), payload_size};
+    const long long send_ns = capture_ ? MillisecondTimer::now_ns() : 0;
+    if (pImpl->send_gather(parts, sizes, 2, result)) {
+        record(result);
     }
+    if (capture_) {
+        capture_->append(send_ns, parts, sizes, 2, static_cast<uint32_t>(result.status));
+    }
+    return result;
+}
 
-    // 1. 准备帧头
-    NetworkFrameHeader header{};
-    header.frame_flag = 0xA5A56666; // 固定的帧头标识
-    header.frame_number = 0;        // 协议要求固定为 0
-    header.frame_length = static_cast<uint32_t>(payload_size);
-    header.reserved = 0;
+SendResult UdpCommunicator::send_frame(const void* frame, size_t frame_size) {
+    SendResult result;
+    if (pImpl->sock == INVALID_SOCKET_HANDLE) {
+        result.status = SendStatus::NOT_INITIALIZED;
+        record(result);
+        return result;
+    }
+    if (frame_size > MAX_UDP_PAYLOAD) {
+        result.status = SendStatus::PAYLOAD_TOO_LARGE;
+        record(result);
+        return result;
+    }
+    const long long send_ns = capture_ ? MillisecondTimer::now_ns() : 0;
+    if (pImpl->send_gather(&frame, &frame_size, 1, result)) {
+        record(result);
+    }
+    if (capture_) {
+        // 时间戳取交给 socket 的时刻，发送结果一并记录，回放时跳过未发出的帧
+        capture_->append(send_ns, &frame, &frame_size, 1, static_cast<uint32_t>(result.status));
+    }
+    return result;
+}
+
+void UdpCommunicator::record(const SendResult& result) {
+    packets_sent_.fetch_add(result.destinations_ok, std::memory_order_relaxed);
+    bytes_sent_.fetch_add(result.bytes_sent, std::memory_order_relaxed);
+    if (result.ok()) {
+        return;
+    }
+    const size_t destinations = pImpl->destinations.size();
+    failures_.fetch_add(destinations > result.destinations_ok ? destinations - result.destinations_ok : 1,
+                        std::memory_order_relaxed);
+    last_failure_.store(result.status, std::memory_order_relaxed);
+    last_error_code_.store(result.error_code, std::memory_order_relaxed);
+}
 
-    // 2. 组合帧头和载荷
-    std::vector<char> packet(sizeof(NetworkFrameHeader) + payload_size);
-    memcpy(packet.data(), &header, sizeof(NetworkFrameHeader));
-    memcpy(packet.data() + sizeof(NetworkFrameHeader), payload, payload_size);
+UdpSendStats UdpCommunicator::get_stats() const {
+    UdpSendStats stats;
+    stats.packets_sent = packets_sent_.load(std::memory_order_relaxed);
+    stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    stats.failures = failures_.load(std::memory_order_relaxed);
+    stats.last_failure = last_failure_.load(std::memory_order_relaxed);
+    stats.last_error_code = last_error_code_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void UdpCommunicator::set_capture(std::shared_ptr<FrameCaptureWriter> capture) {
+    capture_ = std::move(capture);
+}
 
-    // 3. 发送数据包
-    int bytes_sent = sendto(pImpl->sock, packet.data(), static_cast<int>(packet.size()), 0,
-                            (const sockaddr*)&pImpl->server_addr, sizeof(pImpl->server_addr));
+bool UdpCommunicator::set_send_backend(SendBackend backend) {
+#ifdef TRAINSIM_HAVE_IO_URING
+    std::unique_ptr<IoUringSender> sender;
+    if (backend != SendBackend::SENDMSG) {
+        if (pImpl->sock == INVALID_SOCKET_HANDLE) {
+            return false;
+        }
+        sender = std::make_unique<IoUringSender>();
+        if (!sender->open(pImpl->sock, backend == SendBackend::IO_URING_SQPOLL)) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(pImpl->uring_mutex);
+    if (pImpl->uring) {
+        pImpl->drain_uring();
+    }
+    pImpl->uring = std::move(sender);
+    pImpl->backend = backend;
+    return true;
+#else
+    return backend == SendBackend::SENDMSG;
+#endif
+}
+
+SendBackend UdpCommunicator::send_backend() const {
+    return pImpl->backend;
+}
+
+void UdpCommunicator::flush_sends() {
+#ifdef TRAINSIM_HAVE_IO_URING
+    std::lock_guard<std::mutex> lock(pImpl->uring_mutex);
+    if (pImpl->uring) {
+        pImpl->drain_uring();
+    }
+#endif
+}
+
+bool UdpCommunicator::start_receiver(ReceiveHandler handler) {
+    return pImpl->start_receiving(std::move(handler));
+}
+
+void UdpCommunicator::stop_receiver() {
+    pImpl->stop_receiving();
+}
 
-    return bytes_sent == static_cast<int>(packet.size());
+UdpReceiveStats UdpCommunicator::get_receive_stats() const {
+    UdpReceiveStats stats;
+    stats.datagrams_received = pImpl->datagrams_received.load(std::memory_order_relaxed);
+    stats.bytes_received = pImpl->bytes_received.load(std::memory_order_relaxed);
+    stats.malformed = pImpl->malformed.load(std::memory_order_relaxed);
+    return stats;
 }
 
 bool UdpCommunicator::is_initialized() const {
     // 成功初始化的主要标志：pImpl 有效且 socket 句柄有效
-    return pImpl != nullptr && pImpl->sock != INVALID_SOCKET;
+    return pImpl != nullptr && pImpl->sock != INVALID_SOCKET_HANDLE;
 }
@@ -1,13 +1,87 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
+
+struct NetworkFrameHeader;
+class FrameCaptureWriter;
+
+// 单次发送的结果分类
+enum class SendStatus {
+    OK,
+    NOT_INITIALIZED,   // socket 未创建
+    PAYLOAD_TOO_LARGE, // 帧头 + 载荷超过 UDP 报文上限
+    WOULD_BLOCK,       // 发送缓冲区已满（非阻塞或超时）
+    NETWORK_ERROR,     // 其他系统错误，见 error_code
+    PARTIAL            // 实际发送字节数与报文长度不符
+};
+
+const char* send_status_name(SendStatus status);
+
+// 发送后端
+enum class SendBackend {
+    SENDMSG,          // 每帧一次 sendmsg / sendmmsg 系统调用，发送完成后返回
+    IO_URING,         // Linux io_uring：一帧的全部目的地一次提交，异步完成
+    IO_URING_SQPOLL   // 同上，由内核线程轮询提交队列，稳态发送不进入内核（多占用一个内核线程）
+};
+
+const char* send_backend_name(SendBackend backend);
+
+/**
+ * @brief 单次发送的详细结果。多目的地时 status / error_code 取第一个失败的目的地。
+ */
+struct SendResult {
+    SendStatus status = SendStatus::OK;
+    int error_code = 0;     // 失败时的 errno / WSAGetLastError()
+    size_t bytes_sent = 0;  // 含帧头的实际发送字节数（所有目的地之和）
+    size_t destinations_ok = 0; // 整帧发送成功的目的地数
+
+    bool ok() const { return status == SendStatus::OK; }
+};
+
+// 发送计数，可在任意线程读取
+struct UdpSendStats {
+    unsigned long long packets_sent = 0;
+    unsigned long long bytes_sent = 0;
+    unsigned long long failures = 0;
+    SendStatus last_failure = SendStatus::OK;
+    int last_error_code = 0;
+};
+
+// 单个目的地的发送计数
+struct DestinationStats {
+    std::string ip;
+    int port = 0;
+    unsigned long long packets_sent = 0;
+    unsigned long long failures = 0;
+    int last_error_code = 0;
+};
+
+// 接收计数，可在任意线程读取
+struct UdpReceiveStats {
+    unsigned long long datagrams_received = 0;
+    unsigned long long bytes_received = 0;
+    unsigned long long malformed = 0; // 帧头标识或长度不符而被丢弃的报文
+};
 
 /**
  * @brief 一个用于发送UDP数据包的通信器类。
  *
  * 该类封装了底层的socket编程细节，提供了一个简单的send接口。
- * 它会自动处理WSA的初始化与清理，并在析构时关闭socket。
- * 该类会自动为您发送的数据包添加一个通用的网络帧头。
+ * Windows 下使用 Winsock 并自动处理WSA的初始化与清理，其他平台使用 POSIX socket；析构时关闭socket。
+ * 该类会自动为您发送的数据包添加一个通用的网络帧头：帧头与载荷以分散/聚集方式
+ * （POSIX sendmsg / Winsock WSASendTo）一次发出，发送路径上没有内存分配与拷贝。
+ *
+ * 可通过 add_destination 增加多个目的地（单播或组播地址），同一帧在 Linux 下以一次
+ * sendmmsg 系统调用扇出到全部目的地，其他平台逐个发送。高发送率时可切换到 io_uring 后端
+ * （见 set_send_backend），以预分配的发送槽位和批量提交代替逐帧系统调用。
+ *
+ * start_receiver 在独立线程上监听同一 socket（Linux 下为 epoll，其他平台为带超时的 poll），
+ * 对端回复到发送源地址的报文经帧头校验后交给回调；接收与发送互不阻塞。
  */
 class UdpCommunicator {
 public:
@@ -28,20 +102,74 @@ public:
      * @brief 发送一段二进制数据。
      * @param payload 指向要发送的数据（载荷）的指针。
      * @param payload_size 要发送的数据（载荷）的字节大小。
-     * @return true 如果发送成功。
-     * @return false 如果发送失败。
+     * @return 发送结果，ok() 为 true 表示整帧发送成功。
      */
-    bool send(const void* payload, size_t payload_size);
+    SendResult send(const void* payload, size_t payload_size);
+
+    /**
+     * @brief 发送一个已包含帧头的完整网络帧（见 WireFrame），不再添加帧头。
+     * @param frame 帧起始地址（帧头 + 载荷连续存放）
+     * @param frame_size 整帧字节数
+     */
+    SendResult send_frame(const void* frame, size_t frame_size);
+
+    /**
+     * @brief 增加一个目的地，之后的每次 send 都会发往全部目的地。不可与 send 并发调用。
+     * @return 地址无效时返回 false
+     */
+    bool add_destination(const std::string& ip, int port);
+    size_t destination_count() const;
+    // 组播报文的 TTL，默认为 1（仅本网段）
+    bool set_multicast_ttl(int ttl);
 
     bool is_initialized() const;
 
+    /**
+     * @brief 切换发送后端。不可与发送并发调用。
+     *
+     * io_uring 后端下 send 返回时帧已拷贝并提交，但未必已经发出：SendResult 反映提交结果，
+     * 发送错误在完成时计入 get_stats / get_destination_stats。超过槽位大小的帧仍走同步 sendmsg。
+     * @return 平台不支持或内核拒绝时返回 false，保持 SENDMSG 后端
+     */
+    bool set_send_backend(SendBackend backend);
+    SendBackend send_backend() const;
+    // 等待已提交的异步发送全部完成，之后 get_stats 包含此前提交的所有帧；SENDMSG 后端下立即返回
+    void flush_sends();
+
+    // 之后每次发送的完整帧（含帧头）连同时间戳追加到捕获文件；传入空指针停止捕获。不可与发送并发调用
+    void set_capture(std::shared_ptr<FrameCaptureWriter> capture);
+
+    // 在接收线程中调用；payload 仅在回调期间有效
+    using ReceiveHandler = std::function<void(const NetworkFrameHeader& header, const void* payload, size_t payload_size)>;
+
+    /**
+     * @brief 启动接收线程。socket 尚未绑定时先绑定到任意本地端口，之后的发送沿用该端口。
+     * @return 已在接收或创建失败时返回 false
+     */
+    bool start_receiver(ReceiveHandler handler);
+    // 停止并等待接收线程退出，不可在回调中调用
+    void stop_receiver();
+    UdpReceiveStats get_receive_stats() const;
+
+    UdpSendStats get_stats() const;
+    std::vector<DestinationStats> get_destination_stats() const;
+
     // --- 禁止拷贝构造和赋值，以防止socket资源管理混乱 ---
     UdpCommunicator(const UdpCommunicator&) = delete;
     UdpCommunicator& operator=(const UdpCommunicator&) = delete;
 
 private:
+    void record(const SendResult& result);
+
     // 使用PImpl模式（指向实现的指针）来完全隐藏内部成员，
     // 使该头文件无需包含任何平台相关的头文件。
     class UdpImpl;
     UdpImpl* pImpl;
-};
\ No newline at end of file
+
+    std::atomic<unsigned long long> packets_sent_{0};
+    std::atomic<unsigned long long> bytes_sent_{0};
+    std::atomic<unsigned long long> failures_{0};
+    std::atomic<SendStatus> last_failure_{SendStatus::OK};
+    std::atomic<int> last_error_code_{0};
+    std::shared_ptr<FrameCaptureWriter> capture_;
+};
@@ -0,0 +1,184 @@
+//
+// Created by fyh on 25-8-21.
+//
+
+#ifndef WIRELAYOUT_H
+#define WIRELAYOUT_H
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+/**
+ * 编译期字段描述的线上格式。
+ *
+ * 每种报文用 Layout<结构体, 字段...> 按线上顺序列出成员，偏移与总长在编译期求出；
+ * write/read 对每个字段做一次显式小端存取，与主机字节序和结构体对齐方式无关。
+ * 小端主机上每个字段编译为一条定长 store/load，不比整体 memcpy 慢。
+ */
+namespace wire {
+
+template<typename T>
+concept Scalar = std::is_integral_v<T> || std::is_floating_point_v<T>;
+
+template<size_t N> struct unsigned_of;
+template<> struct unsigned_of<1> { using type = uint8_t; };
+template<> struct unsigned_of<2> { using type = uint16_t; };
+template<> struct unsigned_of<4> { using type = uint32_t; };
+template<> struct unsigned_of<8> { using type = uint64_t; };
+
+template<Scalar T>
+inline void store_le(unsigned char* out, T value) {
+    using U = typename unsigned_of<sizeof(T)>::type;
+    const U bits = std::bit_cast<U>(value);
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(out, &bits, sizeof(U));
+    } else {
+        for (size_t i = 0; i < sizeof(U); ++i) {
+            out[i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+    }
+}
+
+template<Scalar T>
+inline T load_le(const unsigned char* in) {
+    using U = typename unsigned_of<sizeof(T)>::type;
+    U bits = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(&bits, in, sizeof(U));
+    } else {
+        for (size_t i = 0; i < sizeof(U); ++i) {
+            bits |= static_cast<U>(in[i]) << (8 * i);
+        }
+    }
+    return std::bit_cast<T>(bits);
+}
+
+template<auto Member> struct member_traits;
+template<typename Owner, typename Type, Type Owner::*Member>
+struct member_traits<Member> {
+    using owner = Owner;
+    using type = Type;
+};
+
+// 一个标量成员或标量数组成员
+template<auto Member>
+struct Field {
+    using type = typename member_traits<Member>::type;
+    using element = std::remove_all_extents_t<type>;
+    static_assert(Scalar<element>, "wire::Field supports scalar members and arrays of scalars");
+    static constexpr size_t count = sizeof(type) / sizeof(element);
+    static constexpr size_t size = sizeof(type);
+
+    template<typename S>
+    static void write(const S& s, unsigned char* out) {
+        if constexpr (std::is_array_v<type>) {
+            for (size_t i = 0; i < count; ++i) {
+                store_le<element>(out + i * sizeof(element), (s.*Member)[i]);
+            }
+        } else {
+            store_le<element>(out, s.*Member);
+        }
+    }
+
+    template<typename S>
+    static void read(const unsigned char* in, S& s) {
+        if constexpr (std::is_array_v<type>) {
+            for (size_t i = 0; i < count; ++i) {
+                (s.*Member)[i] = load_le<element>(in + i * sizeof(element));
+            }
+        } else {
+            s.*Member = load_le<element>(in);
+        }
+    }
+};
+
+// 结构体中没有对应成员的保留区：写入时填 0，读取时跳过
+template<size_t N>
+struct Reserved {
+    static constexpr size_t size = N;
+
+    template<typename S>
+    static void write(const S&, unsigned char* out) {
+        std::memset(out, 0, N);
+    }
+
+    template<typename S>
+    static void read(const unsigned char*, S&) {}
+};
+
+template<typename Struct, typename... Fields>
+struct Layout {
+    static constexpr size_t field_count = sizeof...(Fields);
+    static constexpr size_t size = (Fields::size + ... + 0);
+
+    // 各字段的线上偏移
+    static constexpr std::array<size_t, field_count> offsets = [] {
+        std::array<size_t, field_count> result{};
+        size_t offset = 0;
+        size_t index = 0;
+        ((result[index++] = offset, offset += Fields::size), ...);
+        return result;
+    }();
+
+    static void write(const Struct& s, unsigned char* out) {
+        write_fields(s, out, std::index_sequence_for<Fields...>{});
+    }
+
+    static void read(const unsigned char* in, Struct& s) {
+        read_fields(in, s, std::index_sequence_for<Fields...>{});
+    }
+
+    static Struct read(const unsigned char* in) {
+        Struct s{};
+        read(in, s);
+        return s;
+    }
+
+    // 成员在线上的偏移，成员不在布局中时编译失败
+    template<auto Member>
+    static constexpr size_t offset_of() {
+        constexpr size_t index = index_of<Member>();
+        static_assert(index < field_count, "member is not part of this layout");
+        return offsets[index];
+    }
+
+    // 直接读写线上缓冲中的单个标量字段
+    template<auto Member>
+    static auto get(const unsigned char* in) {
+        return load_le<typename member_traits<Member>::type>(in + offset_of<Member>());
+    }
+
+    template<auto Member>
+    static void set(unsigned char* out, typename member_traits<Member>::type value) {
+        store_le(out + offset_of<Member>(), value);
+    }
+
+private:
+    template<auto Member>
+    static constexpr size_t index_of() {
+        size_t index = 0;
+        size_t result = field_count;
+        ((std::is_same_v<Fields, Field<Member>> && result == field_count ? result = index : 0, ++index), ...);
+        return result;
+    }
+
+    template<size_t... I>
+    static void write_fields(const Struct& s, unsigned char* out, std::index_sequence<I...>) {
+        (Fields::write(s, out + offsets[I]), ...);
+    }
+
+    template<size_t... I>
+    static void read_fields(const unsigned char* in, Struct& s, std::index_sequence<I...>) {
+        (Fields::read(in + offsets[I], s), ...);
+    }
+};
+
+} // namespace wire
+
+#endif //WIRELAYOUT_H
@@ -1,3 +1,4 @@
+#include "Simulator/TextEncoding.h"
 #include "Simulator/TrainSimulator.h"
 #include "TrainSimulatorAPI.h"
 #include "TrajKit/DataTypes.h" // 需要包含此头文件以使用C++的GeodeticPoint
@@ -60,6 +61,11 @@ API_DECL bool StopSimulation(void* simulator_handle) {
     return static_cast<TrainSimulator*>(simulator_handle)->stop_simulation();
 }
 
+API_DECL bool AddDestination(void* simulator_handle, const wchar_t* ip, int port) {
+    if (!simulator_handle || !ip) return false;
+    return static_cast<TrainSimulator*>(simulator_handle)->add_destination(to_utf8(ip), port);
+}
+
 API_DECL void SetControlMode(void* simulator_handle, int mode) {
     if (!simulator_handle) return;
     auto sim = static_cast<TrainSimulator*>(simulator_handle);
@@ -72,11 +78,23 @@ API_DECL void SetControlLevel(void* simulator_handle, int level) {
     sim->set_control_level(static_cast<TrainController::ControlLevel>(level));
 }
 
+API_DECL bool ConfigureClock(void* simulator_handle, int mode, double scale) {
+    if (!simulator_handle) return false;
+    if (mode < 0 || mode > static_cast<int>(ClockMode::MANUAL)) return false;
+    auto sim = static_cast<TrainSimulator*>(simulator_handle);
+    return sim->configure_clock(static_cast<ClockMode>(mode), scale);
+}
+
+API_DECL bool AdvanceSimulationClock(void* simulator_handle, double ms) {
+    if (!simulator_handle) return false;
+    return static_cast<TrainSimulator*>(simulator_handle)->advance_clock(ms);
+}
+
 API_DECL KinematicState_C GetCurrentState(void* simulator_handle) {
     KinematicState_C state_c = {0};
     if (simulator_handle) {
         auto sim = static_cast<TrainSimulator*>(simulator_handle);
-        const KinematicState& state_cpp = sim->getCurrentState(); // 假设 TrainSimulator 有这个方法
+        const KinematicState state_cpp = sim->getCurrentState();
         state_c.position = state_cpp.position;
         state_c.velocity = state_cpp.velocity;
         state_c.acceleration = state_cpp.acceleration;
@@ -85,6 +103,65 @@ API_DECL KinematicState_C GetCurrentState(void* simulator_handle) {
     return state_c;
 }
 
+API_DECL StateSnapshot_C GetStateSnapshot(void* simulator_handle) {
+    StateSnapshot_C snapshot_c = {};
+    if (simulator_handle) {
+        auto sim = static_cast<TrainSimulator*>(simulator_handle);
+        const StateSnapshot snapshot = sim->getStateSnapshot();
+        snapshot_c.state.position = snapshot.state.position;
+        snapshot_c.state.velocity = snapshot.state.velocity;
+        snapshot_c.state.acceleration = snapshot.state.acceleration;
+        snapshot_c.state.jerk = snapshot.state.jerk;
+        snapshot_c.tick = snapshot.tick;
+        snapshot_c.simulation_time_ms = snapshot.simulation_time_ms;
+    }
+    return snapshot_c;
+}
+
+static LatencySummary_C to_latency_summary_c(const LatencySummary& summary) {
+    LatencySummary_C summary_c = {};
+    summary_c.count = summary.count;
+    summary_c.min_us = summary.min_ns / 1000.0;
+    summary_c.mean_us = summary.mean_ns / 1000.0;
+    summary_c.p50_us = summary.p50_ns / 1000.0;
+    summary_c.p90_us = summary.p90_ns / 1000.0;
+    summary_c.p99_us = summary.p99_ns / 1000.0;
+    summary_c.p999_us = summary.p999_ns / 1000.0;
+    summary_c.max_us = summary.max_ns / 1000.0;
+    return summary_c;
+}
+
+API_DECL TickLatencyStats_C GetTickLatencyStats(void* simulator_handle) {
+    TickLatencyStats_C stats_c = {};
+    if (simulator_handle) {
+        auto sim = static_cast<TrainSimulator*>(simulator_handle);
+        stats_c.wake_lateness = to_latency_summary_c(sim->getTickLatency(TickStage::WAKE_LATENESS));
+        stats_c.control = to_latency_summary_c(sim->getTickLatency(TickStage::CONTROL));
+        stats_c.route = to_latency_summary_c(sim->getTickLatency(TickStage::ROUTE));
+        stats_c.send = to_latency_summary_c(sim->getTickLatency(TickStage::SEND));
+        stats_c.total = to_latency_summary_c(sim->getTickLatency(TickStage::TOTAL));
+    }
+    return stats_c;
+}
+
+API_DECL bool EnableFeedback(void* simulator_handle, int ack_timeout_ms) {
+    if (!simulator_handle) return false;
+    return static_cast<TrainSimulator*>(simulator_handle)->enable_feedback(ack_timeout_ms);
+}
+
+API_DECL FeedbackStats_C GetFeedbackStats(void* simulator_handle) {
+    FeedbackStats_C stats_c = {};
+    if (simulator_handle) {
+        const FeedbackStats stats = static_cast<TrainSimulator*>(simulator_handle)->getFeedbackStats();
+        stats_c.replies = stats.replies;
+        stats_c.stream_feedback = stats.stream_feedback;
+        stats_c.last_sent_seq = stats.last_sent_seq;
+        stats_c.last_acked_seq = stats.last_acked_seq;
+        stats_c.peer_lost = stats.peer_lost;
+        stats_c.round_trip = to_latency_summary_c(stats.round_trip);
+    }
+    return stats_c;
+}
 
 // --- 新增API函数的实现 ---
 
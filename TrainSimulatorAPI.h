@@ -20,6 +20,44 @@ struct KinematicState_C {
     double jerk;
 };
 
+// 一致性状态快照：state、周期数与仿真时刻来自同一次发布
+struct StateSnapshot_C {
+    KinematicState_C state;
+    unsigned long long tick;    // 已完成的仿真周期数
+    double simulation_time_ms;  // 2006-01-01 起的毫秒数
+};
+
+// 单个阶段的耗时分布，单位 us
+struct LatencySummary_C {
+    unsigned long long count;
+    double min_us;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+};
+
+// 仿真周期各阶段耗时分布
+struct TickLatencyStats_C {
+    LatencySummary_C wake_lateness; // 唤醒时刻相对期望时刻的滞后
+    LatencySummary_C control;       // 指令处理与动力学推进
+    LatencySummary_C route;         // 线路插值与数据包填充
+    LatencySummary_C send;          // UDP 发送
+    LatencySummary_C total;         // 回调总耗时
+};
+
+// 模拟器回执统计
+struct FeedbackStats_C {
+    unsigned long long replies;          // 匹配上的指令应答数
+    unsigned long long stream_feedback;  // 数据流反馈报文数
+    unsigned long long last_sent_seq;    // 已发送的最大轨迹序号
+    unsigned long long last_acked_seq;   // 模拟器确认的最大轨迹序号
+    unsigned long long peer_lost;        // 模拟器侧缺失的序号数
+    LatencySummary_C round_trip;         // 轨迹帧往返时延
+};
+
 // 新增：用于API层的大地坐标结构体
 struct GeodeticPoint_C {
     double lon; // 经度
@@ -88,12 +126,26 @@ extern "C" {
     API_DECL bool StartSimulation(void* simulator_handle);
     API_DECL bool StopSimulation(void* simulator_handle);
 
+    // 增加一个UDP目的地（单播或组播），须在 StartSimulation 之前（或 StopSimulation 之后）调用，否则返回 false
+    API_DECL bool AddDestination(void* simulator_handle, const wchar_t* ip, int port);
+
     // 模式控制
     API_DECL void SetControlMode(void* simulator_handle, int mode); // 0: Auto, 1: Manual
     API_DECL void SetControlLevel(void* simulator_handle, int level); // 对应 TrainController::ControlLevel 枚举
 
+    // 仿真时钟：mode 0 墙钟，1 按 scale 倍速，2 手动步进；须在 StartSimulation 之前（或 StopSimulation 之后）调用，否则返回 false
+    API_DECL bool ConfigureClock(void* simulator_handle, int mode, double scale);
+    // 手动步进模式下推进虚拟时间 (ms)
+    API_DECL bool AdvanceSimulationClock(void* simulator_handle, double ms);
+
     // 数据获取
     API_DECL KinematicState_C GetCurrentState(void* simulator_handle);
+    API_DECL StateSnapshot_C GetStateSnapshot(void* simulator_handle);
+    API_DECL TickLatencyStats_C GetTickLatencyStats(void* simulator_handle);
+
+    // 启动回执接收；ack_timeout_ms > 0 时 StartSimulation 等待 START 应答
+    API_DECL bool EnableFeedback(void* simulator_handle, int ack_timeout_ms);
+    API_DECL FeedbackStats_C GetFeedbackStats(void* simulator_handle);
 
     // --- 新增的API函数 ---
     // 获取当前速度 (m/s)
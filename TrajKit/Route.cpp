@@ -3,6 +3,12 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 bool Route::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
@@ -45,6 +51,7 @@ bool Route::loadFromFile(const std::string& filename) {
     }
 
     buildSplines();
+    buildTrackProfile();
     m_is_initialized = true;
     return true;
 }
@@ -73,6 +80,56 @@ void Route::buildSplines() {
     m_spline_x.set_points(m_distances, x);
     m_spline_y.set_points(m_distances, y);
     m_spline_z.set_points(m_distances, z);
+
+    // 3. 在每个节点处取出该段的三次多项式系数（节点处的值与各阶导数即为系数）
+    m_segments.resize(m_distances.size());
+    const tk::spline* splines[3] = {&m_spline_x, &m_spline_y, &m_spline_z};
+    for (size_t i = 0; i < m_distances.size(); ++i) {
+        const double s = m_distances[i];
+        double* coefficients[3] = {m_segments[i].x, m_segments[i].y, m_segments[i].z};
+        for (int axis = 0; axis < 3; ++axis) {
+            coefficients[axis][0] = (*splines[axis])(s);
+            coefficients[axis][1] = splines[axis]->deriv(1, s);
+            coefficients[axis][2] = splines[axis]->deriv(2, s) / 2.0;
+            coefficients[axis][3] = splines[axis]->deriv(3, s) / 6.0;
+        }
+    }
+}
+
+void Route::buildTrackProfile() {
+    const auto sample_count = static_cast<size_t>(m_total_distance / PROFILE_SAMPLE_STEP) + 1;
+    std::vector<TrackProfilePoint> samples;
+    samples.reserve(sample_count);
+
+    for (size_t i = 0; i < sample_count; ++i) {
+        const double s = std::min(static_cast<double>(i) * PROFILE_SAMPLE_STEP, m_total_distance);
+
+        // P'(s) 与 P''(s)
+        const double dx = m_spline_x.deriv(1, s), dy = m_spline_y.deriv(1, s), dz = m_spline_z.deriv(1, s);
+        const double ddx = m_spline_x.deriv(2, s), ddy = m_spline_y.deriv(2, s), ddz = m_spline_z.deriv(2, s);
+        const double tangent_norm = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        TrackProfilePoint point;
+        if (tangent_norm > 0.0) {
+            // 坡度：单位切向量在当地椭球法线（天向）上的投影
+            const GeodeticPoint geo = GeoUtils::ecefToGeodetic({m_spline_x(s), m_spline_y(s), m_spline_z(s)});
+            const double lat = geo.lat * M_PI / 180.0;
+            const double lon = geo.lon * M_PI / 180.0;
+            const double up_x = std::cos(lat) * std::cos(lon);
+            const double up_y = std::cos(lat) * std::sin(lon);
+            const double up_z = std::sin(lat);
+            point.grade = (dx * up_x + dy * up_y + dz * up_z) / tangent_norm;
+
+            // 曲率：|P' x P''| / |P'|^3
+            const double cx = dy * ddz - dz * ddy;
+            const double cy = dz * ddx - dx * ddz;
+            const double cz = dx * ddy - dy * ddx;
+            point.curvature = std::sqrt(cx * cx + cy * cy + cz * cz) / (tangent_norm * tangent_norm * tangent_norm);
+        }
+        samples.push_back(point);
+    }
+
+    m_track_profile.assign(std::move(samples), PROFILE_SAMPLE_STEP);
 }
 
 double Route::getTotalDistance() const {
@@ -146,7 +203,66 @@ ECEFPoint Route::getJerkAt(double distance, double speed, double tangential_acce
     };
 }
 
+size_t Route::findSegment(double distance, size_t from) const {
+    // 指数步长向后逼近，再在最后一步内二分；相邻点只隔几个节点时只需几次比较
+    size_t lo = from;
+    size_t step = 1;
+    while (lo + step < m_distances.size() && m_distances[lo + step] <= distance) {
+        lo += step;
+        step *= 2;
+    }
+    const size_t hi = std::min(lo + step, m_distances.size());
+    const auto it = std::upper_bound(m_distances.begin() + static_cast<std::ptrdiff_t>(lo) + 1,
+                                     m_distances.begin() + static_cast<std::ptrdiff_t>(hi), distance);
+    return static_cast<size_t>(it - m_distances.begin()) - 1;
+}
+
+void Route::evaluateBatch(const double* distances, size_t count, double speed, double tangential_accel,
+                          double tangential_jerk, RouteSample* out) const {
+    if (!m_is_initialized) {
+        std::fill(out, out + count, RouteSample{});
+        return;
+    }
+    const double v = speed;
+    const double a = tangential_accel;
+    const double j = tangential_jerk;
+    const double v2 = v * v;
+    const double v3 = v2 * v;
+
+    size_t segment = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double s = std::clamp(distances[i], 0.0, m_total_distance);
+        // 与 tk::spline 相同：取最后一个起点不超过 s 的段（末节点自成一段）；乱序时从头查找
+        segment = findSegment(s, s < m_distances[segment] ? 0 : segment);
+        const SplineSegment& coeffs = m_segments[segment];
+        const double h = s - m_distances[segment];
+
+        // P(s) 及其一至三阶导数
+        double p[3], d1[3], d2[3], d3[3];
+        const double* c[3] = {coeffs.x, coeffs.y, coeffs.z};
+        for (int axis = 0; axis < 3; ++axis) {
+            p[axis] = ((c[axis][3] * h + c[axis][2]) * h + c[axis][1]) * h + c[axis][0];
+            d1[axis] = (3.0 * c[axis][3] * h + 2.0 * c[axis][2]) * h + c[axis][1];
+            d2[axis] = 6.0 * c[axis][3] * h + 2.0 * c[axis][2];
+            d3[axis] = 6.0 * c[axis][3];
+        }
+
+        // 与 getVelocityAt / getAccelerationAt / getJerkAt 相同的链式法则
+        RouteSample& sample = out[i];
+        sample.position = {p[0], p[1], p[2]};
+        sample.velocity = {d1[0] * v, d1[1] * v, d1[2] * v};
+        sample.acceleration = {d1[0] * a + d2[0] * v2, d1[1] * a + d2[1] * v2, d1[2] * a + d2[2] * v2};
+        sample.jerk = {d3[0] * v3 + 3 * d2[0] * v * a + d1[0] * j,
+                       d3[1] * v3 + 3 * d2[1] * v * a + d1[1] * j,
+                       d3[2] * v3 + 3 * d2[2] * v * a + d1[2] * j};
+    }
+}
+
 // 新增的函数实现
 bool Route::isInitialized() const {
     return m_is_initialized;
 }
+
+const TrackProfile& Route::getTrackProfile() const {
+    return m_track_profile;
+}
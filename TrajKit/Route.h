@@ -8,8 +8,17 @@
 #include <string>
 #include <vector>
 #include "DataTypes.h"
+#include "TrackProfile.h"
 #include "spline.h" // 假设 spline.h 在包含路径中
 
+// 线路上一点的位置及速度、加速度、加加速度矢量
+struct RouteSample {
+    ECEFPoint position;
+    ECEFPoint velocity;
+    ECEFPoint acceleration;
+    ECEFPoint jerk;
+};
+
 class Route {
 public:
     Route() = default;
@@ -32,12 +41,31 @@ public:
     // 新增的 getJerkAt 函数
     ECEFPoint getJerkAt(double distance, double speed, double tangential_accel, double tangential_jerk) const;
 
+    /**
+     * @brief 同一列车上 count 个点的批量求值（刚体编组：各点共享切向速率、加速度与加加速度）。
+     *
+     * 每个点只定位一次样条段，再由同一组系数得到位置与三阶导数；distances 按升序排列时
+     * 后一个点从前一个点的段开始向后查找，段定位只在第一个点做一次完整二分。
+     * 距离超出 [0, 总里程] 时按端点处理，结果与逐点调用 get*At 一致（误差在舍入量级）。
+     */
+    void evaluateBatch(const double* distances, size_t count, double speed, double tangential_accel,
+                       double tangential_jerk, RouteSample* out) const;
+
     // 新增：检查路由是否已初始化
     bool isInitialized() const;
 
+    // 获取加载时预计算的坡度/曲率剖面表
+    const TrackProfile& getTrackProfile() const;
+
 private:
     // 构建样条曲线的私有辅助函数
     void buildSplines();
+    // 从 from 段（起点不超过 distance）向后查找 distance 所在的段
+    size_t findSegment(double distance, size_t from) const;
+    // 沿走行距离等间隔采样坡度与曲率，供动力学查表
+    void buildTrackProfile();
+
+    static constexpr double PROFILE_SAMPLE_STEP = 10.0; // 剖面采样间隔 (m)
 
     // 私有成员变量，封装内部状态
     std::vector<double> m_distances; // 每个点的走行距离 s
@@ -47,6 +75,16 @@ private:
     tk::spline m_spline_y;
     tk::spline m_spline_z;
 
+    // 每个样条段在段起点处的多项式系数：值、一阶导、二阶导/2、三阶导/6，供批量求值按段复用
+    struct SplineSegment {
+        double x[4];
+        double y[4];
+        double z[4];
+    };
+    std::vector<SplineSegment> m_segments;
+
+    TrackProfile m_track_profile;
+
     double m_total_distance = 0.0;
     bool m_is_initialized = false;
 };
@@ -0,0 +1,55 @@
+//
+// Created by fyh on 25-8-12.
+//
+
+#ifndef TRACKPROFILE_H
+#define TRACKPROFILE_H
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+// 线路纵断面/平面在某一里程处的几何信息
+struct TrackProfilePoint {
+    double grade = 0.0;     // 坡度 (上坡为正, 无量纲, 即 sinθ)
+    double curvature = 0.0; // 曲率 (1/m), 即 1/R
+};
+
+/**
+ * @brief 沿走行距离等间隔采样的线路剖面表。
+ *
+ * 在加载路线时由 Route 一次性预计算，仿真每个周期只需一次查表，
+ * 不再需要对样条求导。
+ */
+class TrackProfile {
+public:
+    TrackProfile() = default;
+
+    // 用等间隔采样点重建剖面表，samples[i] 对应走行距离 i * step
+    void assign(std::vector<TrackProfilePoint> samples, double step) {
+        samples_ = std::move(samples);
+        step_ = step;
+        inv_step_ = step > 0.0 ? 1.0 / step : 0.0;
+    }
+
+    // 取距离 s 处最近的采样点，超出范围时取端点；空表返回平直线路
+    TrackProfilePoint at(double distance) const {
+        if (samples_.empty()) return {};
+        const double pos = distance * inv_step_ + 0.5;
+        if (pos <= 0.0) return samples_.front();
+        const auto idx = static_cast<size_t>(pos);
+        return idx < samples_.size() ? samples_[idx] : samples_.back();
+    }
+
+    bool empty() const { return samples_.empty(); }
+    size_t size() const { return samples_.size(); }
+    double step() const { return step_; }
+
+private:
+    std::vector<TrackProfilePoint> samples_;
+    double step_ = 0.0;
+    double inv_step_ = 0.0;
+};
+
+#endif //TRACKPROFILE_H